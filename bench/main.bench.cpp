@@ -0,0 +1,21 @@
+#include <benchmark/benchmark.h>
+
+#include <SDL3/SDL_hints.h>
+
+int
+main(int argc, char** argv)
+{
+    // headless by default, `SDL_VIDEO_DRIVER` environment variable still takes precedence
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
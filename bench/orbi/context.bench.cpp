@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+
+#include <orbi/context.hpp>
+#include <orbi/window.hpp>
+
+namespace
+{
+
+void
+context_create(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        orbi::context ctx;
+        benchmark::DoNotOptimize(ctx);
+    }
+}
+
+void
+window_create(benchmark::State& state)
+{
+    orbi::context const ctx;
+
+    for (auto _ : state)
+    {
+        orbi::window window{ ctx };
+        benchmark::DoNotOptimize(window);
+    }
+}
+
+} // namespace
+
+BENCHMARK(context_create)->Unit(benchmark::kMillisecond);
+BENCHMARK(window_create)->Unit(benchmark::kMillisecond);
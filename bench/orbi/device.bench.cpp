@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include <orbi/context.hpp>
+#include <orbi/device.hpp>
+#include <orbi/window.hpp>
+
+namespace
+{
+
+void
+device_create(benchmark::State& state)
+{
+    orbi::context const ctx;
+    orbi::window const window{ ctx };
+
+    for (auto _ : state)
+    {
+        orbi::device device{ ctx, window };
+        benchmark::DoNotOptimize(device);
+    }
+}
+
+void
+device_candidates(benchmark::State& state)
+{
+    orbi::context const ctx;
+    orbi::window const window{ ctx };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(orbi::device::candidates(ctx, window));
+    }
+}
+
+} // namespace
+
+BENCHMARK(device_create)->Unit(benchmark::kMillisecond);
+BENCHMARK(device_candidates)->Unit(benchmark::kMicrosecond);
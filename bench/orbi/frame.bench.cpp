@@ -0,0 +1,193 @@
+#include <benchmark/benchmark.h>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/offscreen_target.hpp>
+#include <orbi/readback_stream.hpp>
+#include <orbi/renderer.hpp>
+#include <orbi/rendering.hpp>
+#include <orbi/swapchain.hpp>
+#include <orbi/window.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+
+namespace
+{
+
+/*
+    clears and presents one swapchain image
+
+    @return `false` if no image was acquired
+*/
+bool
+clear_frame(orbi::device const& device, orbi::swapchain& swapchain, orbi::renderer& renderer)
+{
+    using namespace orbi;
+
+    renderer.begin_frame();
+
+    auto const image_index{ swapchain.acquire(renderer) };
+    if (!image_index)
+    {
+        renderer.end_frame();
+        return false;
+    }
+
+    auto const& device_impl{ device::impl::from_device(device) };
+    auto const& swapchain_impl{ swapchain::impl::from_swapchain(swapchain) };
+    auto& renderer_impl{ renderer::impl::from_renderer(renderer) };
+    auto const& command_buffer{ renderer_impl.current().command_buffer };
+    auto const image{ swapchain_impl.images[*image_index] };
+
+    command_buffer.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    transition(command_buffer, image, image_states::acquired, image_states::color_attachment);
+
+    std::array const color_attachments{ color_attachment_info{
+        .view = swapchain_impl.image_views[*image_index] } };
+    begin_rendering(command_buffer, vk::Rect2D{ { 0, 0 }, swapchain_impl.extent }, color_attachments);
+    command_buffer.endRendering();
+
+    transition(command_buffer, image, image_states::color_attachment, image_states::present);
+    command_buffer.end();
+
+    renderer_impl.submit(device_impl.graphics_queue.vk_queue, swapchain_impl.render_finished[*image_index]);
+    swapchain.present(*image_index);
+
+    renderer.end_frame();
+
+    return true;
+}
+
+// the same frame as `clear_frame`, but on headless device without acquire and present
+void
+clear_offscreen_frame(orbi::device const& device, orbi::offscreen_target const& target, orbi::renderer& renderer)
+{
+    using namespace orbi;
+
+    renderer.begin_frame();
+
+    auto const& device_impl{ device::impl::from_device(device) };
+    auto& renderer_impl{ renderer::impl::from_renderer(renderer) };
+    auto const& command_buffer{ renderer_impl.current().command_buffer };
+
+    command_buffer.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    transition(command_buffer, target.image(), image_states::discarded, image_states::color_attachment);
+
+    std::array const color_attachments{ color_attachment_info{ .view = target.view() } };
+    begin_rendering(command_buffer, vk::Rect2D{ { 0, 0 }, target.extent() }, color_attachments);
+    command_buffer.endRendering();
+
+    command_buffer.end();
+
+    renderer_impl.submit(device_impl.graphics_queue.vk_queue);
+
+    renderer.end_frame();
+}
+
+// swapchain is created lazily, so its creation is measured together with the first frame
+void
+swapchain_first_frame(benchmark::State& state)
+{
+    orbi::context const ctx;
+    orbi::window const window{ ctx };
+    orbi::device const device{ ctx, window };
+    orbi::renderer renderer{ device };
+
+    for (auto _ : state)
+    {
+        orbi::swapchain swapchain{ device, window };
+        if (!clear_frame(device, swapchain, renderer))
+        {
+            state.SkipWithError("swapchain image wasn't acquired");
+            break;
+        }
+
+        device.wait_until_idle();
+    }
+}
+
+void
+frame_throughput(benchmark::State& state)
+{
+    orbi::context const ctx;
+    orbi::window const window{ ctx };
+    orbi::device const device{ ctx, window };
+    orbi::swapchain swapchain{ device, window };
+    orbi::renderer renderer{ device, static_cast<orbi::renderer::frame_index_type>(state.range(0)) };
+
+    std::int64_t frames{ 0 };
+    for (auto _ : state)
+    {
+        frames += clear_frame(device, swapchain, renderer) ? 1 : 0;
+    }
+
+    device.wait_until_idle();
+
+    // reported as `items_per_second`, i.e. frames per second
+    state.SetItemsProcessed(frames);
+}
+
+void
+offscreen_frame_throughput(benchmark::State& state)
+{
+    orbi::context const ctx{ {}, { .headless = true } };
+    orbi::device const device{ ctx };
+    orbi::offscreen_target const target{ device, { 500, 500 } };
+    orbi::renderer renderer{ device, static_cast<orbi::renderer::frame_index_type>(state.range(0)) };
+
+    for (auto _ : state)
+    {
+        clear_offscreen_frame(device, target, renderer);
+    }
+
+    device.wait_until_idle();
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// every frame is copied to cpu, should be bound by copy bandwidth rather than by latency of each copy
+void
+offscreen_readback_throughput(benchmark::State& state)
+{
+    orbi::context const ctx{ {}, { .headless = true } };
+    orbi::device const device{ ctx };
+    orbi::offscreen_target const target{ device, { 1920, 1080 } };
+    orbi::renderer renderer{ device };
+    orbi::readback_stream stream{ device, target.extent(), target.format(),
+                                  [](orbi::readback_frame const& frame) { benchmark::DoNotOptimize(frame.pixels[0]); },
+                                  static_cast<std::uint32_t>(state.range(0)) };
+
+    for (auto _ : state)
+    {
+        clear_offscreen_frame(device, target, renderer);
+        stream.push(target);
+    }
+
+    stream.flush();
+
+    auto const stats{ stream.stats() };
+    state.SetItemsProcessed(static_cast<std::int64_t>(stats.frames_consumed));
+    state.SetBytesProcessed(static_cast<std::int64_t>(stats.bytes_consumed));
+    state.counters["stalls"] = static_cast<double>(stats.stalls);
+}
+
+} // namespace
+
+BENCHMARK(swapchain_first_frame)->Unit(benchmark::kMillisecond);
+BENCHMARK(frame_throughput)->ArgName("frames_in_flight")->Arg(1)->Arg(2)->Arg(3)->Unit(benchmark::kMicrosecond);
+BENCHMARK(offscreen_frame_throughput)
+    ->ArgName("frames_in_flight")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(3)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(offscreen_readback_throughput)
+    ->ArgName("depth")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(3)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond);
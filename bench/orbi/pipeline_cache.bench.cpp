@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/pipeline_cache.hpp>
+#include <orbi/window.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <filesystem>
+
+// generated by `orbi_target_shaders`, defines `bench::shaders`
+#include <bench/shaders.hpp>
+
+namespace
+{
+
+struct triangle
+{
+    explicit triangle(orbi::device const& device)
+        : vk_device{ orbi::device::impl::from_device(device).vk_device }
+    {
+    }
+
+    vk::raii::Pipeline
+    create(orbi::pipeline_cache const& cache) const
+    {
+        std::array const stages{
+            vk::PipelineShaderStageCreateInfo{ .stage = vk::ShaderStageFlagBits::eVertex,
+                                               .module = vertex,
+                                               .pName = "main" },
+            vk::PipelineShaderStageCreateInfo{ .stage = vk::ShaderStageFlagBits::eFragment,
+                                               .module = fragment,
+                                               .pName = "main" },
+        };
+
+        vk::PipelineVertexInputStateCreateInfo const vertex_input{};
+        vk::PipelineInputAssemblyStateCreateInfo const input_assembly{ .topology =
+                                                                           vk::PrimitiveTopology::eTriangleList };
+        vk::PipelineViewportStateCreateInfo const viewport{ .viewportCount = 1, .scissorCount = 1 };
+        vk::PipelineRasterizationStateCreateInfo const rasterization{ .polygonMode = vk::PolygonMode::eFill,
+                                                                      .cullMode = vk::CullModeFlagBits::eBack,
+                                                                      .frontFace = vk::FrontFace::eClockwise,
+                                                                      .lineWidth = 1 };
+        vk::PipelineMultisampleStateCreateInfo const multisample{ .rasterizationSamples =
+                                                                      vk::SampleCountFlagBits::e1 };
+        vk::PipelineColorBlendAttachmentState const blend_attachment{
+            .colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                              vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA
+        };
+        vk::PipelineColorBlendStateCreateInfo const color_blend{ .attachmentCount = 1,
+                                                                 .pAttachments = &blend_attachment };
+        std::array const dynamic_states{ vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+        vk::PipelineDynamicStateCreateInfo const dynamic_state{ .dynamicStateCount = dynamic_states.size(),
+                                                                .pDynamicStates = dynamic_states.data() };
+
+        auto const format{ vk::Format::eB8G8R8A8Unorm };
+        vk::PipelineRenderingCreateInfo const rendering{ .colorAttachmentCount = 1,
+                                                         .pColorAttachmentFormats = &format };
+
+        return { vk_device, orbi::pipeline_cache::impl::from_pipeline_cache(cache).vk_pipeline_cache,
+                 vk::GraphicsPipelineCreateInfo{ .pNext = &rendering,
+                                                 .stageCount = stages.size(),
+                                                 .pStages = stages.data(),
+                                                 .pVertexInputState = &vertex_input,
+                                                 .pInputAssemblyState = &input_assembly,
+                                                 .pViewportState = &viewport,
+                                                 .pRasterizationState = &rasterization,
+                                                 .pMultisampleState = &multisample,
+                                                 .pColorBlendState = &color_blend,
+                                                 .pDynamicState = &dynamic_state,
+                                                 .layout = layout } };
+    }
+
+    vk::raii::Device const& vk_device;
+
+    static constexpr auto vertex_code{ bench::shaders.at("triangle.vert") };
+    static constexpr auto fragment_code{ bench::shaders.at("triangle.frag") };
+
+    vk::raii::ShaderModule const vertex{ vk_device,
+                                         { .codeSize = vertex_code.size_bytes(),
+                                           .pCode = vertex_code.data() } };
+    vk::raii::ShaderModule const fragment{ vk_device,
+                                           { .codeSize = fragment_code.size_bytes(),
+                                             .pCode = fragment_code.data() } };
+    vk::raii::PipelineLayout const layout{ vk_device, vk::PipelineLayoutCreateInfo{} };
+};
+
+// every iteration starts with empty cache, so driver compiles from scratch
+void
+pipeline_create_cold(benchmark::State& state)
+{
+    orbi::context const ctx;
+    orbi::window const window{ ctx };
+    orbi::device const device{ ctx, window };
+    triangle const t{ device };
+
+    for (auto _ : state)
+    {
+        orbi::pipeline_cache const cache{ device, {} };
+        benchmark::DoNotOptimize(t.create(cache));
+    }
+}
+
+// cache is saved to disk and loaded back, as on second launch of application
+void
+pipeline_create_warm(benchmark::State& state)
+{
+    orbi::context const ctx;
+    orbi::window const window{ ctx };
+    orbi::device const device{ ctx, window };
+    triangle const t{ device };
+
+    auto const directory{ std::filesystem::temp_directory_path() / "orbi_bench_pipeline_cache" };
+    std::filesystem::remove_all(directory);
+
+    {
+        orbi::pipeline_cache const cache{ device, directory };
+        t.create(cache);
+    }
+
+    orbi::pipeline_cache const cache{ device, directory };
+    if (!cache.warm())
+    {
+        state.SkipWithError("pipeline cache wasn't loaded from disk");
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(t.create(cache));
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace
+
+BENCHMARK(pipeline_create_cold)->Unit(benchmark::kMicrosecond);
+BENCHMARK(pipeline_create_warm)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,63 @@
+#[[
+  orbi_add_archive(<target> OUTPUT <archive> [ZSTD] [BASE_DIR <dir>] FILES <file>...)
+
+  adds <target>, which packs FILES into <archive> read by `orbi::asset_archive`
+  with `orbi_pack` tool of `orbi/CMakeLists.txt`
+
+  entry is named by path of file relative to BASE_DIR (`CMAKE_CURRENT_SOURCE_DIR` by default),
+  GLSL shaders are compiled to SPIR-V first and `.spv` is appended to their names,
+  e.g. `res/triangle.vert` becomes `res/triangle.vert.spv`,
+  other files are packed as is, so they must be in layout expected by GPU already
+
+  ZSTD compresses entries, which become smaller, `orbi` must be built with `ORBI_ZSTD` to read them
+]]
+
+include(shaders)
+
+function(orbi_add_archive target)
+  cmake_parse_arguments(arg "ZSTD" "OUTPUT;BASE_DIR" "FILES" ${ARGN})
+
+  if(NOT arg_OUTPUT)
+    message(FATAL_ERROR "orbi_add_archive: OUTPUT is required")
+  endif()
+
+  if(NOT arg_BASE_DIR)
+    set(arg_BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
+  endif()
+
+  get_filename_component(output "${arg_OUTPUT}" ABSOLUTE BASE_DIR
+                         "${CMAKE_CURRENT_BINARY_DIR}")
+  get_filename_component(base_dir "${arg_BASE_DIR}" ABSOLUTE)
+
+  set(inputs)
+  set(depends)
+
+  foreach(file IN LISTS arg_FILES)
+    get_filename_component(path "${file}" ABSOLUTE)
+    file(RELATIVE_PATH name "${base_dir}" "${path}")
+
+    if(path MATCHES "\\.(vert|frag|comp|geom|tesc|tese|task|mesh)$")
+      set(spirv "${CMAKE_CURRENT_BINARY_DIR}/${target}/${name}.spv")
+      orbi_compile_glsl("${path}" "${spirv}")
+
+      set(path "${spirv}")
+      string(APPEND name ".spv")
+    endif()
+
+    list(APPEND inputs "${name}=${path}")
+    list(APPEND depends "${path}")
+  endforeach()
+
+  set(zstd)
+  if(arg_ZSTD)
+    set(zstd --zstd)
+  endif()
+
+  add_custom_command(
+    OUTPUT "${output}"
+    COMMAND orbi_pack ${zstd} --output "${output}" ${inputs}
+    DEPENDS orbi_pack ${depends}
+    VERBATIM)
+
+  add_custom_target(${target} DEPENDS "${output}")
+endfunction()
@@ -0,0 +1,149 @@
+#[[
+  orbi_compile_glsl(<input> <output>)
+
+  adds custom command, which compiles GLSL <input> to SPIR-V <output> with glslangValidator of Vulkan SDK
+
+  orbi_target_shaders(<target> HEADER <header> [NAMESPACE <namespace>] [VARIABLE <variable>]
+                      [BASE_DIR <dir>] FILES <file>...)
+
+  compiles GLSL FILES and embeds their SPIR-V into generated <header>,
+  which is included by sources of <target> as `#include <header>`,
+  the header defines `constexpr orbi::shader_registry <namespace>::<variable>` (`shaders` by default)
+
+  shader is named by path of file relative to BASE_DIR (`CMAKE_CURRENT_SOURCE_DIR` by default),
+  e.g. `res/triangle.vert` with BASE_DIR `res` becomes `triangle.vert`
+
+  the same file is also a script run with `cmake -P` to generate the header
+]]
+
+if(CMAKE_SCRIPT_MODE_FILE)
+  # arguments are passed as `-D`, lists are separated by `|` to survive command line
+  string(REPLACE "|" ";" names "${NAMES}")
+  string(REPLACE "|" ";" files "${FILES}")
+
+  set(arrays "")
+  set(entries "")
+
+  list(LENGTH names count)
+
+  set(index 0)
+  while(index LESS count)
+    list(GET names ${index} name)
+    list(GET files ${index} file)
+    math(EXPR index "${index} + 1")
+
+    file(READ "${file}" hex HEX)
+
+    string(LENGTH "${hex}" length)
+    math(EXPR remainder "${length} % 8")
+    if(length EQUAL 0 OR NOT remainder EQUAL 0)
+      message(FATAL_ERROR "orbi_target_shaders: '${file}' isn't SPIR-V")
+    endif()
+
+    # SPIR-V words are little endian
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])"
+                         "0x\\4\\3\\2\\1, " words "${hex}")
+
+    # 8 words per line
+    set(word "0x[0-9a-f]+, ")
+    string(REGEX REPLACE "(${word}${word}${word}${word}${word}${word}${word}${word})" "\\1\n    " words
+                         "${words}")
+    string(REPLACE ", \n" ",\n" words "${words}")
+    string(REGEX REPLACE "[, \n]+$" "," words "${words}")
+
+    string(MAKE_C_IDENTIFIER "${name}" identifier)
+    string(APPEND arrays "inline constexpr std::uint32_t ${identifier}[]{\n    ${words}\n};\n\n")
+    string(APPEND entries "    orbi::embedded_shader{ \"${name}\", spirv::${identifier} },\n")
+  endwhile()
+
+  file(WRITE "${OUTPUT}"
+       "// generated by `orbi_target_shaders` of `cmake/shaders.cmake`, don't edit\n"
+       "#pragma once\n\n"
+       "#include <orbi/shader_registry.hpp>\n\n"
+       "#include <cstdint>\n\n"
+       "namespace ${NAMESPACE}\n{\n\n"
+       "namespace spirv\n{\n\n"
+       "${arrays}"
+       "} // namespace spirv\n\n"
+       "inline constexpr orbi::shader_registry<${count}> ${VARIABLE}{ {\n"
+       "${entries}"
+       "} };\n\n"
+       "} // namespace ${NAMESPACE}\n")
+
+  return()
+endif()
+
+# cached, so it's visible to functions called from other directories
+set(orbi_shaders_script
+    "${CMAKE_CURRENT_LIST_FILE}"
+    CACHE INTERNAL "")
+
+function(orbi_compile_glsl input output)
+  if(NOT Vulkan_GLSLANG_VALIDATOR_EXECUTABLE)
+    message(FATAL_ERROR "glslangValidator is not found, it's needed to compile '${input}'")
+  endif()
+
+  get_filename_component(output_dir "${output}" DIRECTORY)
+
+  add_custom_command(
+    OUTPUT "${output}"
+    COMMAND "${CMAKE_COMMAND}" -E make_directory "${output_dir}"
+    COMMAND "${Vulkan_GLSLANG_VALIDATOR_EXECUTABLE}" -V --target-env vulkan1.3
+            -o "${output}" "${input}"
+    DEPENDS "${input}"
+    VERBATIM)
+endfunction()
+
+function(orbi_target_shaders target)
+  cmake_parse_arguments(arg "" "HEADER;NAMESPACE;VARIABLE;BASE_DIR" "FILES" ${ARGN})
+
+  if(NOT arg_HEADER)
+    message(FATAL_ERROR "orbi_target_shaders: HEADER is required")
+  endif()
+
+  if(NOT arg_NAMESPACE)
+    set(arg_NAMESPACE "shaders")
+  endif()
+
+  if(NOT arg_VARIABLE)
+    set(arg_VARIABLE "shaders")
+  endif()
+
+  if(NOT arg_BASE_DIR)
+    set(arg_BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
+  endif()
+
+  get_filename_component(base_dir "${arg_BASE_DIR}" ABSOLUTE)
+
+  set(generated_dir "${CMAKE_CURRENT_BINARY_DIR}/${target}_shaders")
+  set(header "${generated_dir}/${arg_HEADER}")
+
+  set(names)
+  set(spirvs)
+
+  foreach(file IN LISTS arg_FILES)
+    get_filename_component(path "${file}" ABSOLUTE)
+    file(RELATIVE_PATH name "${base_dir}" "${path}")
+
+    set(spirv "${generated_dir}/spirv/${name}.spv")
+    orbi_compile_glsl("${path}" "${spirv}")
+
+    list(APPEND names "${name}")
+    list(APPEND spirvs "${spirv}")
+  endforeach()
+
+  string(REPLACE ";" "|" names_arg "${names}")
+  string(REPLACE ";" "|" files_arg "${spirvs}")
+
+  add_custom_command(
+    OUTPUT "${header}"
+    COMMAND "${CMAKE_COMMAND}" "-DOUTPUT=${header}" "-DNAMESPACE=${arg_NAMESPACE}"
+            "-DVARIABLE=${arg_VARIABLE}" "-DNAMES=${names_arg}" "-DFILES=${files_arg}"
+            -P "${orbi_shaders_script}"
+    DEPENDS ${spirvs} "${orbi_shaders_script}"
+    VERBATIM)
+
+  # generated header is a source, so it's generated before sources including it are compiled
+  target_sources(${target} PRIVATE "${header}")
+  target_include_directories(${target} PRIVATE "${generated_dir}")
+endfunction()
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <orbi/asset_source.hpp>
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/exception.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace orbi
+{
+
+/*
+    assets packed into one file by `orbi_pack` tool, see `orbi_add_archive` of `cmake/archive.cmake`
+
+    archive is opened and mapped once, so thousands of assets cost one open instead of thousands of them,
+    entries are views into mapping, e.g. SPIR-V goes to `pipeline_compiler` and vertices to `uploader::upload`
+    without copies, only compressed entries are decompressed into memory
+
+    all member functions are thread safe
+*/
+struct asset_archive
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    /*
+        @param path of archive, relative to root of `source`
+        @throw `asset_archive::error` if archive can't be opened or is corrupted
+    */
+    asset_archive(asset_source const& source, std::filesystem::path const& path);
+    ~asset_archive();
+
+    asset_archive(asset_archive&&) noexcept;
+    asset_archive& operator=(asset_archive);
+
+    friend void swap(asset_archive&, asset_archive&) noexcept;
+
+    /*
+        assets share mapping of archive, so they stay valid after `asset_archive` is destroyed
+
+        @param name of entry given to packer, e.g. `shaders/triangle.vert.spv`
+        @throw `asset_archive::error` if there is no such entry
+               or it's compressed, but can't be decompressed (e.g. orbi is built without `ORBI_ZSTD`)
+    */
+    asset open(std::string_view name) const;
+
+    bool contains(std::string_view name) const noexcept;
+
+    // count of entries
+    std::uint32_t size() const noexcept;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 64, 8> data;
+};
+
+} // namespace orbi
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <span>
+
+namespace orbi
+{
+
+/*
+    bytes of asset, e.g. mapped file, copies share them
+*/
+struct asset
+{
+    std::span<std::byte const> bytes;
+    // keeps `bytes` alive, they are released (e.g. unmapped) with the last copy
+    std::shared_ptr<void const> storage;
+
+    /*
+        e.g. SPIR-V for `vk::ShaderModuleCreateInfo`
+
+        @pre `bytes` are aligned to and their size is multiple of `sizeof(std::uint32_t)`,
+             which holds for whole files of `asset_source`
+    */
+    std::span<std::uint32_t const>
+    words() const noexcept
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return { reinterpret_cast<std::uint32_t const*>(bytes.data()), bytes.size() / sizeof(std::uint32_t) };
+    }
+};
+
+/*
+    loads assets from files under root directory without copying them through streams
+
+    `open` maps file, so pages are read by OS only when they are touched
+    and are shared with page cache instead of being copied to heap,
+    `read` reads whole file into memory on worker thread, e.g. to prefetch it
+
+    all member functions are thread safe
+*/
+struct asset_source
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    /*
+        @param root relative paths are resolved against it
+        @param thread_count of workers for `read`, see `detail::thread_pool`
+        @throw `asset_source::error` if workers can't be started
+    */
+    explicit asset_source(std::filesystem::path root, std::uint32_t thread_count = 1);
+    ~asset_source();
+
+    asset_source(asset_source&&) noexcept;
+    asset_source& operator=(asset_source);
+
+    friend void swap(asset_source&, asset_source&) noexcept;
+
+    /*
+        maps file into memory, file which can't be mapped (e.g. pipe) is read instead
+
+        @throw `asset_source::error` if file can't be opened or read
+    */
+    asset open(std::filesystem::path const&) const;
+
+    /*
+        reads whole file on worker thread
+
+        @return future of asset, it holds `asset_source::error` if file can't be opened or read
+    */
+    std::future<asset> read(std::filesystem::path const&) const;
+
+    std::filesystem::path const& root() const noexcept;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 48, 8> data;
+};
+
+} // namespace orbi
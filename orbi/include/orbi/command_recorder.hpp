@@ -0,0 +1,112 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+#include <orbi/renderer.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace orbi
+{
+
+struct device;
+
+/*
+    formats of dynamic rendering, which secondary command buffers are recorded for,
+    must match rendering begun in primary command buffer
+*/
+struct rendering_inheritance
+{
+    std::vector<vk::Format> color_formats;
+    vk::Format depth_format{ vk::Format::eUndefined };
+};
+
+/*
+    records secondary command buffers in parallel
+
+    `[0, count)` of `record` is split into contiguous ranges, one per thread,
+    calling thread records the first range, worker threads record the rest
+
+    each range has its own command pool per frame in flight and its own secondary command buffer,
+    so recording never synchronizes on a pool,
+    buffers are executed in primary command buffer in order of ranges
+
+    `record` and `record_rendering` may be called several times per frame,
+    each call takes new command buffers, which are reset with pools by `begin_frame`
+*/
+struct command_recorder
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    using frame_index_type = renderer::frame_index_type;
+
+    /*
+        records `[first, last)` into `command_buffer`,
+        it is called concurrently from different threads with disjoint ranges
+
+        secondary command buffers inherit no dynamic state, so viewport and scissor must be set by each range
+    */
+    using record_function =
+        std::function<void(vk::raii::CommandBuffer const& command_buffer, std::uint32_t first, std::uint32_t last)>;
+
+    /*
+        `worker_count == 0` means `std::thread::hardware_concurrency() - 1`, but at least one thread
+
+        @pre `dev` must outlive `*this`
+        @throw `command_recorder::error`
+    */
+    command_recorder(device const&, frame_index_type frames_in_flight, std::uint32_t worker_count = 0);
+    ~command_recorder();
+
+    command_recorder(command_recorder&&) noexcept;
+    command_recorder& operator=(command_recorder);
+
+    friend void swap(command_recorder&, command_recorder&) noexcept;
+
+    /*
+        resets command pools of current frame of `r`
+
+        @pre `r.begin_frame()` was called, so gpu doesn't use command buffers of this frame
+        @pre `r.frames_in_flight()` is the same as passed to constructor
+        @throw `command_recorder::error`
+    */
+    void begin_frame(renderer const& r);
+
+    /*
+        records secondary command buffers outside of rendering and executes them in `primary`
+
+        exception thrown by `fn` is rethrown after all threads are finished
+
+        @throw `command_recorder::error` or exception of `fn`
+    */
+    void record(vk::raii::CommandBuffer const& primary, std::uint32_t count, record_function const& fn);
+
+    /*
+        records secondary command buffers, which continue dynamic rendering begun in `primary`
+        with `vk::RenderingFlagBits::eContentsSecondaryCommandBuffers`, and executes them in `primary`
+
+        @throw `command_recorder::error` or exception of `fn`
+    */
+    void record_rendering(vk::raii::CommandBuffer const& primary, rendering_inheritance const&, std::uint32_t count,
+                          record_function const& fn);
+
+    // number of threads recording in parallel, including calling thread
+    std::uint32_t thread_count() const noexcept;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 48, 8> data;
+};
+
+} // namespace orbi
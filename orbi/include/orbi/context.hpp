@@ -1,11 +1,14 @@
 #pragma once
 
+#include <orbi/debug_log.hpp>
 #include <orbi/detail/pimpl.hpp>
 #include <orbi/detail/util.hpp>
 #include <orbi/exception.hpp>
 
 #include <vulkan/vulkan_raii.hpp>
 
+#include <vector>
+
 namespace orbi
 {
 
@@ -22,6 +25,48 @@ struct app_info
     version semver{ 0, 1, 0 };
 };
 
+/*
+    how much debugging support is enabled, each level includes previous ones
+*/
+enum class instrumentation : std::uint8_t
+{
+    // no `VK_EXT_debug_utils`, no layers, object naming and labels are skipped
+    none,
+    // `VK_EXT_debug_utils` for object names and command buffer labels, e.g. for RenderDoc
+    markers,
+    // `VK_LAYER_KHRONOS_validation` with messages delivered to `context_options::debug_sinks`
+    validation,
+    // validation layer additionally instruments shaders, it's much slower
+    gpu_assisted,
+};
+
+struct context_options
+{
+    /*
+        SDL video isn't initialized and surface extensions aren't enabled,
+        so context works without display server, e.g. for server-side rendering
+
+        `window` can't be created with headless context, use `device` constructor without window
+        and render to `offscreen_target`
+    */
+    bool headless{ false };
+
+    /*
+        receive validation messages on background thread, so driver threads never wait for formatting or I/O,
+        repeated messages are reported once with number of repeats
+
+        empty means `stderr_sink()`, unused if `instrumentation_level` is below `instrumentation::validation`
+    */
+    std::vector<debug_sink> debug_sinks;
+
+    // release builds pay nothing for debugging by default
+#ifdef NDEBUG
+    instrumentation instrumentation_level{ instrumentation::none };
+#else
+    instrumentation instrumentation_level{ instrumentation::validation };
+#endif
+};
+
 struct context
 {
 public:
@@ -31,9 +76,9 @@ public:
     };
 
     /*
-        @throw `ctx::error`
+        @throw `ctx::error`, e.g. if validation layer is requested, but isn't installed
     */
-    explicit context(app_info const& = {});
+    explicit context(app_info const& = {}, context_options const& = {});
     ~context();
 
     context(context&&) noexcept;
@@ -41,13 +86,17 @@ public:
 
     friend void swap(context&, context&) noexcept;
 
+    bool headless() const noexcept;
+
+    instrumentation instrumentation_level() const noexcept;
+
     struct impl;
     friend impl;
 
 private:
     bool need_release_resource{ true };
 
-    detail::pimpl<impl, 72, 8> data;
+    detail::pimpl<impl, 88, 8> data;
 };
 
 } // namespace orbi
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string_view>
+
+namespace orbi
+{
+
+/*
+    message of `VK_EXT_debug_utils` as delivered to sinks on background thread of `context`
+*/
+struct debug_message
+{
+    vk::DebugUtilsMessageSeverityFlagBitsEXT severity{ vk::DebugUtilsMessageSeverityFlagBitsEXT::eInfo };
+    vk::DebugUtilsMessageTypeFlagsEXT type{};
+    std::int32_t id{ 0 };
+
+    // formatted message with its objects and labels, valid only during call of sink
+    std::string_view text;
+
+    /*
+        `0` for the first message with `id`, next messages with the same `id` are only counted
+        and reported periodically by summary message, which `repeats` is number of them since previous summary
+    */
+    std::uint64_t repeats{ 0 };
+};
+
+/*
+    called on background thread, only one message at a time,
+    exceptions thrown by sink are ignored
+*/
+using debug_sink = std::function<void(debug_message const&)>;
+
+// writes every message to `stderr`
+debug_sink stderr_sink();
+
+/*
+    appends every message to file at `path`, file is flushed after each message
+
+    @throw `orbi::runtime_error` if file can't be opened
+*/
+debug_sink file_sink(std::filesystem::path const& path);
+
+} // namespace orbi
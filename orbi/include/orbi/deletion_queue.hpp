@@ -0,0 +1,104 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+#include <orbi/renderer.hpp>
+#include <orbi/timeline.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace orbi
+{
+
+/*
+    destroys resources only after gpu is done with them, so replacing resource
+    (e.g. on resize) never needs `device::wait_until_idle`
+
+    resource is any movable object, e.g. `vk::raii::Buffer` or struct of raii handles,
+    it is destroyed by `collect` once its timeline reaches value it was pushed with
+
+    resources of timeline, which is destroyed itself, are destroyed by the next `collect`,
+    destructor of timeline waits until gpu doesn't use semaphore anymore, so all its values are reached
+
+    one queue is owned by `device`, see `device::deletion`, `renderer::begin_frame` collects it
+
+    all member functions are thread safe
+*/
+struct deletion_queue
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    deletion_queue();
+
+    /*
+        destroys all remaining resources without waiting
+
+        @pre gpu doesn't use them anymore, e.g. device is idle
+    */
+    ~deletion_queue();
+
+    deletion_queue(deletion_queue&&) noexcept;
+    deletion_queue& operator=(deletion_queue);
+
+    friend void swap(deletion_queue&, deletion_queue&) noexcept;
+
+    /*
+        takes ownership of `resource` and destroys it once `t` reaches `value`
+
+        @pre `value` is signaled eventually, e.g. it was reserved by `t.advance()` and submitted
+    */
+    template <class Resource>
+    void
+    push(timeline const& t, timeline::value_type const value, Resource&& resource)
+    {
+        push_erased(t, value, std::make_shared<std::decay_t<Resource>>(std::forward<Resource>(resource)));
+    }
+
+    /*
+        destroys `resource` once all frames already submitted by `r` are finished
+    */
+    template <class Resource>
+    void
+    push(renderer const& r, Resource&& resource)
+    {
+        auto const& t{ r.frame_timeline() };
+        push(t, t.last(), std::forward<Resource>(resource));
+    }
+
+    /*
+        destroys resources, which timelines reached their values, doesn't block,
+        each timeline is queried at most once
+
+        @return number of destroyed resources
+        @throw `deletion_queue::error`
+    */
+    std::size_t collect();
+
+    /*
+        waits for all pushed values and destroys all resources
+
+        @throw `deletion_queue::error`
+    */
+    void flush();
+
+    // number of resources waiting for destruction
+    std::size_t size() const;
+
+    struct impl;
+    friend impl;
+
+private:
+    void push_erased(timeline const&, timeline::value_type, std::shared_ptr<void>);
+
+    detail::pimpl<impl, 8, 8> data;
+};
+
+} // namespace orbi
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+
+namespace orbi
+{
+
+struct device;
+struct renderer;
+
+/*
+    index of descriptor in array of `descriptor_heap` binding of `Type`,
+    it's passed to shaders as is, e.g. in push constants
+*/
+template <vk::DescriptorType Type>
+struct descriptor_handle
+{
+    static constexpr vk::DescriptorType type{ Type };
+    static constexpr std::uint32_t invalid_index{ ~std::uint32_t{ 0 } };
+
+    std::uint32_t index{ invalid_index };
+
+    explicit operator bool() const noexcept
+    {
+        return index != invalid_index;
+    }
+};
+
+using sampled_image_handle = descriptor_handle<vk::DescriptorType::eSampledImage>;
+using storage_buffer_handle = descriptor_handle<vk::DescriptorType::eStorageBuffer>;
+using sampler_handle = descriptor_handle<vk::DescriptorType::eSampler>;
+
+/*
+    counts are upper bounds: they are reduced to update-after-bind descriptor limits of device,
+    so the default capacity fits any device, see `descriptor_heap::capacity`
+*/
+struct descriptor_heap_capacity
+{
+    std::uint32_t sampled_images{ 65536 };
+    std::uint32_t storage_buffers{ 65536 };
+    std::uint32_t samplers{ 256 };
+};
+
+/*
+    bindless descriptors: one update-after-bind descriptor set with array per descriptor type,
+    so it's bound once per command buffer, and draws select resources by `descriptor_handle` index
+
+    in GLSL (with `GL_EXT_nonuniform_qualifier`):
+
+        layout(set = 0, binding = 0) uniform texture2D sampled_images[];
+        layout(set = 0, binding = 1) buffer storage_buffer { uint data[]; } storage_buffers[];
+        layout(set = 0, binding = 2) uniform sampler samplers[];
+
+    bindings are partially bound, so only descriptors actually used by gpu must be valid
+
+    all member functions are thread safe
+*/
+struct descriptor_heap
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    static constexpr std::uint32_t sampled_image_binding{ 0 };
+    static constexpr std::uint32_t storage_buffer_binding{ 1 };
+    static constexpr std::uint32_t sampler_binding{ 2 };
+
+    // minimal size of push constants guaranteed by vulkan
+    static constexpr std::uint32_t push_constant_size{ 128 };
+
+    /*
+        @pre `dev` was created with `device_options::bindless`
+        @pre `dev` must outlive `*this`
+        @throw `descriptor_heap::error`
+    */
+    explicit descriptor_heap(device const&, descriptor_heap_capacity const& = {});
+    ~descriptor_heap();
+
+    descriptor_heap(descriptor_heap&&) noexcept;
+    descriptor_heap& operator=(descriptor_heap);
+
+    friend void swap(descriptor_heap&, descriptor_heap&) noexcept;
+
+    /*
+        writes descriptor into free slot, it can be used by commands recorded after this call,
+        even if set is already bound
+
+        @pre resource outlives its handle
+        @throw `descriptor_heap::error` if heap is full
+    */
+    sampled_image_handle add(vk::ImageView, vk::ImageLayout = vk::ImageLayout::eShaderReadOnlyOptimal);
+    storage_buffer_handle add(vk::Buffer, vk::DeviceSize offset = 0, vk::DeviceSize range = vk::WholeSize);
+    sampler_handle add(vk::Sampler);
+
+    /*
+        frees slot of handle for reuse right away
+
+        @pre handle isn't used by gpu anymore
+    */
+    template <vk::DescriptorType Type>
+    void
+    remove(descriptor_handle<Type> const h)
+    {
+        release(Type, h.index);
+    }
+
+    /*
+        frees slot of handle once all frames already submitted by `r` are finished,
+        see `device::deletion`
+    */
+    template <vk::DescriptorType Type>
+    void
+    remove(descriptor_handle<Type> const h, renderer const& r)
+    {
+        release(Type, h.index, r);
+    }
+
+    // capacity passed to constructor reduced to limits of device
+    descriptor_heap_capacity capacity() const noexcept;
+
+    vk::DescriptorSetLayout set_layout() const noexcept;
+    vk::DescriptorSet set() const noexcept;
+
+    /*
+        the only pipeline layout needed by bindless pipelines:
+        set `0` is `set()` and `push_constant_size` bytes of push constants are visible to all stages
+    */
+    vk::PipelineLayout pipeline_layout() const noexcept;
+
+    // binds `set()` as set `0` of `pipeline_layout()`
+    void bind(vk::raii::CommandBuffer const&, vk::PipelineBindPoint) const;
+
+    struct impl;
+    friend impl;
+
+private:
+    void release(vk::DescriptorType, std::uint32_t index);
+    void release(vk::DescriptorType, std::uint32_t index, renderer const&);
+
+    detail::pimpl<impl, 144, 8> data;
+};
+
+} // namespace orbi
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <orbi/exception.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+    format of packed asset archive, shared by `orbi::asset_archive` and `orbi_pack` tool
+
+    [archive_header][archive_entry x entry_count][names][payload][payload]...
+
+    entries are sorted by name, so they are found with binary search right in mapped file,
+    each payload starts at multiple of `archive_alignment`, so it can be used in place,
+    e.g. as SPIR-V or as source of buffer copy
+*/
+namespace orbi::detail
+{
+
+// everything is written as is
+static_assert(std::endian::native == std::endian::little);
+
+constexpr std::array<char, 8> archive_magic{ 'O', 'R', 'B', 'I', 'P', 'A', 'K', '\0' };
+constexpr std::uint32_t archive_version{ 1 };
+
+// satisfies `optimalBufferCopyOffsetAlignment` of all known devices and alignment of SPIR-V words
+constexpr std::uint64_t archive_alignment{ 256 };
+
+enum class archive_compression : std::uint32_t
+{
+    none,
+    // available only with `ORBI_ZSTD`
+    zstd,
+};
+
+struct archive_header
+{
+    std::array<char, 8> magic{};
+    std::uint32_t version{ 0 };
+    std::uint32_t entry_count{ 0 };
+    std::uint64_t names_offset{ 0 };
+    std::uint64_t names_size{ 0 };
+};
+
+struct archive_entry
+{
+    std::uint64_t offset{ 0 };
+    // in archive, differs from `size` only for compressed entry
+    std::uint64_t stored_size{ 0 };
+    std::uint64_t size{ 0 };
+    // relative to `archive_header::names_offset`
+    std::uint32_t name_offset{ 0 };
+    std::uint32_t name_size{ 0 };
+    archive_compression compression{ archive_compression::none };
+    std::uint32_t reserved{ 0 };
+};
+
+// they are written as is, so they must have no padding
+static_assert(sizeof(archive_header) == 32);
+static_assert(sizeof(archive_entry) == 40);
+static_assert(std::is_trivially_copyable_v<archive_header>);
+static_assert(std::is_trivially_copyable_v<archive_entry>);
+
+struct archive_input
+{
+    // e.g. `shaders/triangle.vert.spv`, with `/` as separator on every platform
+    std::string name;
+    std::filesystem::path path;
+};
+
+struct archive_error : runtime_error
+{
+    using runtime_error::runtime_error;
+};
+
+/*
+    packs files into archive, file is replaced atomically
+
+    @param compress with zstd entries, which become smaller,
+           others are stored as is, so they are still used in place
+    @throw `archive_error` if input can't be read, output can't be written, names aren't unique
+           or `compress` is requested without `ORBI_ZSTD`
+*/
+void write_archive(std::filesystem::path const& output, std::span<archive_input const> inputs, bool compress);
+
+} // namespace orbi::detail
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <orbi/debug_log.hpp>
+#include <orbi/detail/mpsc_queue.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace orbi::detail
+{
+
+/*
+    receiver of `VK_EXT_debug_utils` messages, which doesn't block driver
+
+    `push` copies message into lock-free queue without allocation or formatting and wakes background thread,
+    which formats it and passes it to sinks
+
+    messages are deduplicated by `messageIdNumber`: only the first one with each id is queued,
+    next ones just increment counter, which is reported by summary once per `summary_interval`
+*/
+struct debug_log
+{
+public:
+    static constexpr std::size_t queue_capacity{ 256 };
+    static constexpr std::size_t dedup_capacity{ 1024 };
+    static constexpr std::chrono::milliseconds summary_interval{ 1000 };
+
+    // empty `sinks` means `stderr_sink()`
+    explicit debug_log(std::vector<debug_sink> sinks);
+
+    /*
+        delivers all queued messages and pending summaries, then joins background thread
+
+        @pre `push` isn't called anymore, i.e. messenger is already destroyed
+    */
+    ~debug_log();
+
+    debug_log(debug_log const&) = delete;
+    debug_log& operator=(debug_log const&) = delete;
+
+    /*
+        lock-free and doesn't allocate, so it can be called by driver from any thread
+
+        @return `true` if message was queued,
+                `false` if it was counted as duplicate or dropped, because queue is full
+    */
+    bool push(vk::DebugUtilsMessageSeverityFlagBitsEXT, vk::DebugUtilsMessageTypeFlagsEXT,
+              vk::DebugUtilsMessengerCallbackDataEXT const&) noexcept;
+
+    /*
+        `vkDebugUtilsMessengerCallbackEXT`, which pushes message to `debug_log` passed as `user_data`
+    */
+    static VKAPI_ATTR VkBool32 VKAPI_CALL callback(VkDebugUtilsMessageSeverityFlagBitsEXT,
+                                                   VkDebugUtilsMessageTypeFlagsEXT,
+                                                   VkDebugUtilsMessengerCallbackDataEXT const*, void* user_data);
+
+private:
+    static constexpr std::size_t max_objects{ 4 };
+    static constexpr std::size_t max_labels{ 4 };
+    static constexpr std::size_t max_chars{ 2048 };
+
+    // part of `entry::chars`
+    struct text_range
+    {
+        std::uint16_t offset{ 0 };
+        std::uint16_t size{ 0 };
+    };
+
+    struct object
+    {
+        vk::ObjectType type{ vk::ObjectType::eUnknown };
+        std::uint64_t handle{ 0 };
+        text_range name;
+    };
+
+    // copy of `VkDebugUtilsMessengerCallbackDataEXT`, strings are truncated to fit into `chars`
+    struct entry
+    {
+        vk::DebugUtilsMessageSeverityFlagBitsEXT severity{ vk::DebugUtilsMessageSeverityFlagBitsEXT::eInfo };
+        vk::DebugUtilsMessageTypeFlagsEXT type{};
+        std::int32_t id{ 0 };
+        text_range id_name;
+        text_range message;
+
+        std::array<object, max_objects> objects{};
+        std::array<text_range, max_labels> queue_labels{};
+        std::array<text_range, max_labels> command_buffer_labels{};
+        std::uint32_t object_count{ 0 };
+        std::uint32_t queue_label_count{ 0 };
+        std::uint32_t command_buffer_label_count{ 0 };
+
+        std::uint16_t chars_used{ 0 };
+        std::array<char, max_chars> chars{};
+    };
+
+    struct dedup_slot
+    {
+        // `0` marks free slot, message with id `0` is never deduplicated
+        std::atomic<std::int32_t> id{ 0 };
+        // messages with id, which were queued or deduplicated
+        std::atomic<std::uint64_t> count{ 0 };
+        // message with id is in queue or already delivered, so next ones are duplicates
+        std::atomic<bool> queued{ false };
+    };
+
+    // consumer side state of deduplicated id
+    struct seen
+    {
+        vk::DebugUtilsMessageSeverityFlagBitsEXT severity{ vk::DebugUtilsMessageSeverityFlagBitsEXT::eInfo };
+        vk::DebugUtilsMessageTypeFlagsEXT type{};
+        std::string id_name;
+        // messages already delivered or reported by summary
+        std::uint64_t reported{ 1 };
+    };
+
+    // @return part of `e.chars` with as much of `text` as fits
+    static text_range append(entry& e, char const* text) noexcept;
+
+    static void fill(entry&, vk::DebugUtilsMessageSeverityFlagBitsEXT, vk::DebugUtilsMessageTypeFlagsEXT,
+                     vk::DebugUtilsMessengerCallbackDataEXT const&) noexcept;
+
+    static std::string format(entry const&);
+
+    /*
+        @return slot of `id` or `nullptr` if table is full
+    */
+    dedup_slot* slot_of(std::int32_t id) noexcept;
+
+    void run();
+    void drain();
+    void report_repeats();
+    void report_dropped();
+    void deliver(debug_message const&) const noexcept;
+
+    std::vector<debug_sink> sinks;
+
+    std::unique_ptr<mpsc_queue<entry, queue_capacity>> queue;
+    std::unique_ptr<std::array<dedup_slot, dedup_capacity>> dedup;
+    std::atomic<std::uint64_t> dropped{ 0 };
+    // set by `push`, so background thread doesn't sleep with messages in queue
+    std::atomic<bool> pushed{ false };
+
+    // accessed only by background thread
+    std::map<std::int32_t, seen> seen_ids;
+
+    std::mutex mutex;
+    std::condition_variable wake_up;
+    bool stopping{ false };
+
+    // declared last, so it is started after everything it uses is constructed
+    std::thread thread;
+};
+
+} // namespace orbi::detail
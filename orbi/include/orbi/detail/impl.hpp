@@ -1,9 +1,45 @@
 #pragma once
 
+#include <orbi/asset_archive.hpp>
+#include <orbi/asset_source.hpp>
+#include <orbi/command_recorder.hpp>
 #include <orbi/context.hpp>
+#include <orbi/deletion_queue.hpp>
+#include <orbi/descriptor_heap.hpp>
+#include <orbi/detail/archive.hpp>
+#include <orbi/detail/debug_log.hpp>
+#include <orbi/detail/thread_pool.hpp>
+#include <orbi/detail/tlsf.hpp>
 #include <orbi/device.hpp>
+#include <orbi/external.hpp>
+#include <orbi/gpu_profiler.hpp>
+#include <orbi/gpu_allocator.hpp>
+#include <orbi/indirect_draws.hpp>
+#include <orbi/offscreen_target.hpp>
+#include <orbi/pipeline_cache.hpp>
+#include <orbi/pipeline_compiler.hpp>
+#include <orbi/readback_stream.hpp>
+#include <orbi/renderer.hpp>
+#include <orbi/swapchain.hpp>
+#include <orbi/timeline.hpp>
+#include <orbi/trace.hpp>
+#include <orbi/uploader.hpp>
 #include <orbi/window.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <cstdint>
+#include <format>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+
 namespace orbi
 {
 
@@ -23,7 +59,11 @@ struct context::impl
 
     vk::raii::Context vulkan_context;
     vk::raii::Instance vulkan_instance{ nullptr };
+    // messenger is destroyed first, so `log` doesn't receive messages while it's stopping
+    std::unique_ptr<detail::debug_log> log;
     vk::raii::DebugUtilsMessengerEXT debug_utils_messenger{ nullptr };
+    bool headless{ false };
+    instrumentation instrumentation_level{ instrumentation::none };
 };
 
 struct window::impl
@@ -59,12 +99,1018 @@ struct device::impl
         return *c.data;
     }
 
+    using queue_family_index_type = std::uint32_t;
+
+    /*
+        queue tagged with its purpose
+
+        queue without dedicated family is other `VkQueue` of graphics family if the family has enough of them,
+        otherwise it is the same `VkQueue` as graphics one (`aliases_graphics`),
+        then submissions to both must be externally synchronized
+    */
+    template <queue_type Type>
+    struct queue
+    {
+        static constexpr queue_type type{ Type };
+
+        vk::raii::Queue vk_queue{ nullptr };
+        queue_family_index_type family_index{ 0 };
+        bool dedicated{ false };
+        bool aliases_graphics{ false };
+    };
+
+    /*
+        queue family ownership transfer of buffer range
+
+        `record_release` must be recorded on queue of source family and `record_acquire` on destination one,
+        submission with acquire must wait (e.g. on semaphore) for submission with release
+
+        if both families are the same, ownership transfer isn't needed
+        and `record_acquire` becomes an ordinary memory barrier
+    */
+    struct buffer_ownership_transfer
+    {
+        vk::BufferMemoryBarrier release;
+        vk::BufferMemoryBarrier acquire;
+
+        bool
+        required() const noexcept
+        {
+            return release.srcQueueFamilyIndex != release.dstQueueFamilyIndex;
+        }
+
+        void
+        record_release(vk::raii::CommandBuffer const& cmd, vk::PipelineStageFlags const src_stage) const
+        {
+            if (required())
+            {
+                cmd.pipelineBarrier(src_stage, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, release, {});
+            }
+        }
+
+        void
+        record_acquire(vk::raii::CommandBuffer const& cmd, vk::PipelineStageFlags const src_stage,
+                       vk::PipelineStageFlags const dst_stage) const
+        {
+            // execution dependency with release is provided by semaphore
+            auto const stage{ required() ? vk::PipelineStageFlagBits::eTopOfPipe : src_stage };
+            cmd.pipelineBarrier(stage, dst_stage, {}, {}, acquire, {});
+        }
+    };
+
+    /*
+        the same as `buffer_ownership_transfer`, but for image,
+        layout transition (if any) is the part of both barriers
+    */
+    struct image_ownership_transfer
+    {
+        vk::ImageMemoryBarrier release;
+        vk::ImageMemoryBarrier acquire;
+
+        bool
+        required() const noexcept
+        {
+            return release.srcQueueFamilyIndex != release.dstQueueFamilyIndex;
+        }
+
+        void
+        record_release(vk::raii::CommandBuffer const& cmd, vk::PipelineStageFlags const src_stage) const
+        {
+            if (required())
+            {
+                cmd.pipelineBarrier(src_stage, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {}, release);
+            }
+        }
+
+        void
+        record_acquire(vk::raii::CommandBuffer const& cmd, vk::PipelineStageFlags const src_stage,
+                       vk::PipelineStageFlags const dst_stage) const
+        {
+            auto const stage{ required() ? vk::PipelineStageFlagBits::eTopOfPipe : src_stage };
+            cmd.pipelineBarrier(stage, dst_stage, {}, {}, {}, acquire);
+        }
+    };
+
+    template <queue_type Src, queue_type Dst>
+    static buffer_ownership_transfer
+    make_ownership_transfer(queue<Src> const& src, queue<Dst> const& dst, vk::Buffer const buffer,
+                            vk::AccessFlags const src_access, vk::AccessFlags const dst_access,
+                            vk::DeviceSize const offset = 0, vk::DeviceSize const size = vk::WholeSize)
+    {
+        auto const [src_family, dst_family] = transfer_families(src, dst);
+
+        return { .release = { .srcAccessMask = src_access,
+                              .dstAccessMask = {},
+                              .srcQueueFamilyIndex = src_family,
+                              .dstQueueFamilyIndex = dst_family,
+                              .buffer = buffer,
+                              .offset = offset,
+                              .size = size },
+                 .acquire = { .srcAccessMask = src_family == dst_family ? src_access : vk::AccessFlags{},
+                              .dstAccessMask = dst_access,
+                              .srcQueueFamilyIndex = src_family,
+                              .dstQueueFamilyIndex = dst_family,
+                              .buffer = buffer,
+                              .offset = offset,
+                              .size = size } };
+    }
+
+    template <queue_type Src, queue_type Dst>
+    static image_ownership_transfer
+    make_ownership_transfer(queue<Src> const& src, queue<Dst> const& dst, vk::Image const image,
+                            vk::ImageSubresourceRange const& range, vk::ImageLayout const old_layout,
+                            vk::ImageLayout const new_layout, vk::AccessFlags const src_access,
+                            vk::AccessFlags const dst_access)
+    {
+        auto const [src_family, dst_family] = transfer_families(src, dst);
+
+        return { .release = { .srcAccessMask = src_access,
+                              .dstAccessMask = {},
+                              .oldLayout = old_layout,
+                              .newLayout = new_layout,
+                              .srcQueueFamilyIndex = src_family,
+                              .dstQueueFamilyIndex = dst_family,
+                              .image = image,
+                              .subresourceRange = range },
+                 .acquire = { .srcAccessMask = src_family == dst_family ? src_access : vk::AccessFlags{},
+                              .dstAccessMask = dst_access,
+                              .oldLayout = old_layout,
+                              .newLayout = new_layout,
+                              .srcQueueFamilyIndex = src_family,
+                              .dstQueueFamilyIndex = dst_family,
+                              .image = image,
+                              .subresourceRange = range } };
+    }
+
+    template <queue_type Src, queue_type Dst>
+    static std::pair<queue_family_index_type, queue_family_index_type>
+    transfer_families(queue<Src> const& src, queue<Dst> const& dst) noexcept
+    {
+        if (src.family_index == dst.family_index)
+        {
+            return { vk::QueueFamilyIgnored, vk::QueueFamilyIgnored };
+        }
+
+        return { src.family_index, dst.family_index };
+    }
+
+    /*
+        names object for validation messages and graphics debuggers,
+        nothing is formatted or called unless instrumentation is at least `instrumentation::markers`
+    */
+    template <class Handle, class... Args>
+    void
+    set_name(Handle const handle, std::format_string<Args...> fmt, Args&&... args) const
+    {
+        if (!debug_markers)
+        {
+            return;
+        }
+
+        auto const name{ std::format(fmt, std::forward<Args>(args)...) };
+        vk_device.setDebugUtilsObjectNameEXT(
+            { .objectType = Handle::objectType,
+              .objectHandle = reinterpret_cast<std::uint64_t>(static_cast<typename Handle::CType>(handle)),
+              .pObjectName = name.c_str() });
+    }
+
+    /*
+        labels commands recorded until `end_label` for graphics debuggers,
+        no-op unless instrumentation is at least `instrumentation::markers`
+
+        @pre each `begin_label` has `end_label` in the same command buffer
+    */
+    void
+    begin_label(vk::raii::CommandBuffer const& cmd, char const* const name) const
+    {
+        if (debug_markers)
+        {
+            cmd.beginDebugUtilsLabelEXT({ .pLabelName = name });
+        }
+    }
+
+    void
+    end_label(vk::raii::CommandBuffer const& cmd) const
+    {
+        if (debug_markers)
+        {
+            cmd.endDebugUtilsLabelEXT();
+        }
+    }
+
     vk::raii::PhysicalDevice vk_physical_device{ nullptr };
     vk::raii::Device vk_device{ nullptr };
 
-    using queue_family_index_type = std::uint32_t;
-    queue_family_index_type graphics_queue_family_index{ 0 };
-    queue_family_index_type present_queue_family_index{ 0 };
+    queue<queue_type::graphics> graphics_queue;
+    queue<queue_type::present> present_queue;
+    queue<queue_type::compute> compute_queue;
+    queue<queue_type::transfer> transfer_queue;
+
+    // created without surface, so it has no `VK_KHR_swapchain`
+    bool headless{ false };
+    bool external_memory{ false };
+    bool bindless{ false };
+    bool indirect_draw{ false };
+    // `VK_EXT_debug_utils` is enabled by context, see `set_name`
+    bool debug_markers{ false };
+
+    // declared after `vk_device`, so it is destroyed before it
+    std::unique_ptr<gpu_allocator> allocator;
+    std::unique_ptr<pipeline_cache> cache;
+    // null unless `bindless`
+    std::unique_ptr<descriptor_heap> descriptors;
+    // declared last, resources in it may still own memory of `allocator`
+    std::unique_ptr<deletion_queue> deletion;
+};
+
+struct renderer::impl
+{
+    static renderer::impl&
+    from_renderer(renderer& c)
+    {
+        return *c.data;
+    }
+
+    static renderer::impl const&
+    from_renderer(renderer const& c)
+    {
+        return *c.data;
+    }
+
+    struct frame
+    {
+        vk::raii::CommandPool command_pool{ nullptr };
+        vk::raii::CommandBuffer command_buffer{ nullptr };
+        vk::raii::Semaphore image_available{ nullptr };
+        // value of `frame_timeline` signaled by the last submission of frame
+        timeline::value_type submitted{ 0 };
+        // added by `renderer::wait_for`, cleared by submission
+        std::vector<vk::SemaphoreSubmitInfo> waits;
+    };
+
+    frame&
+    current() noexcept
+    {
+        return frames[current_frame];
+    }
+
+    frame const&
+    current() const noexcept
+    {
+        return frames[current_frame];
+    }
+
+    /*
+        @pre `begin_frame` was called for current frame
+    */
+    void
+    submit(vk::raii::Queue const& queue, vk::Semaphore const render_finished)
+    {
+        ORBI_TRACE_SCOPE("renderer::submit");
+
+        auto& frame{ current() };
+        auto const value{ frame_timeline->advance() };
+
+        frame.waits.push_back({ .semaphore = frame.image_available,
+                                .stageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput });
+        vk::CommandBufferSubmitInfo const command_buffer_info{ .commandBuffer = frame.command_buffer };
+        std::array const signal_infos{ vk::SemaphoreSubmitInfo{ .semaphore = render_finished,
+                                                                .stageMask = vk::PipelineStageFlagBits2::eAllCommands },
+                                       frame_timeline->submit_info(value) };
+
+        queue.submit2(vk::SubmitInfo2{ .waitSemaphoreInfoCount = static_cast<std::uint32_t>(frame.waits.size()),
+                                       .pWaitSemaphoreInfos = frame.waits.data(),
+                                       .commandBufferInfoCount = 1,
+                                       .pCommandBufferInfos = &command_buffer_info,
+                                       .signalSemaphoreInfoCount = signal_infos.size(),
+                                       .pSignalSemaphoreInfos = signal_infos.data() });
+
+        frame.submitted = value;
+        frame.waits.clear();
+    }
+
+    /*
+        submits frame, which renders to `offscreen_target`,
+        there is no swapchain image to wait for and nothing to present
+
+        `signal_semaphores` are signaled after all commands, e.g. `external_semaphore` of other process
+
+        @pre `begin_frame` was called for current frame
+    */
+    void
+    submit(vk::raii::Queue const& queue, std::span<vk::Semaphore const> const signal_semaphores = {})
+    {
+        ORBI_TRACE_SCOPE("renderer::submit");
+
+        auto& frame{ current() };
+        auto const value{ frame_timeline->advance() };
+
+        vk::CommandBufferSubmitInfo const command_buffer_info{ .commandBuffer = frame.command_buffer };
+
+        std::vector<vk::SemaphoreSubmitInfo> signal_infos;
+        signal_infos.reserve(signal_semaphores.size() + 1);
+        for (auto const semaphore : signal_semaphores)
+        {
+            signal_infos.push_back({ .semaphore = semaphore, .stageMask = vk::PipelineStageFlagBits2::eAllCommands });
+        }
+        signal_infos.push_back(frame_timeline->submit_info(value));
+
+        queue.submit2(vk::SubmitInfo2{ .waitSemaphoreInfoCount = static_cast<std::uint32_t>(frame.waits.size()),
+                                       .pWaitSemaphoreInfos = frame.waits.data(),
+                                       .commandBufferInfoCount = 1,
+                                       .pCommandBufferInfos = &command_buffer_info,
+                                       .signalSemaphoreInfoCount = static_cast<std::uint32_t>(signal_infos.size()),
+                                       .pSignalSemaphoreInfos = signal_infos.data() });
+
+        frame.submitted = value;
+        frame.waits.clear();
+    }
+
+    device::impl const* dev{ nullptr };
+    std::vector<frame> frames;
+    frame_index_type current_frame{ 0 };
+    // signaled by every submission of every frame, replaces fence per frame
+    std::unique_ptr<timeline> frame_timeline;
+};
+
+struct swapchain::impl
+{
+    static swapchain::impl&
+    from_swapchain(swapchain& c)
+    {
+        return *c.data;
+    }
+
+    static swapchain::impl const&
+    from_swapchain(swapchain const& c)
+    {
+        return *c.data;
+    }
+
+    device::impl const* dev{ nullptr };
+    window::impl const* win{ nullptr };
+    vk::raii::SwapchainKHR vk_swapchain{ nullptr };
+    vk::SurfaceFormatKHR surface_format{};
+    vk::Extent2D extent{};
+    vk::PresentModeKHR present_mode{ vk::PresentModeKHR::eFifo };
+    bool out_of_date{ true };
+    std::vector<vk::Image> images;
+    std::vector<vk::raii::ImageView> image_views;
+    std::vector<vk::raii::Semaphore> render_finished;
+    std::uint64_t generation{ 0 };
+};
+
+struct gpu_allocator::impl
+{
+    static gpu_allocator::impl&
+    from_allocator(gpu_allocator& c)
+    {
+        return *c.data;
+    }
+
+    static gpu_allocator::impl const&
+    from_allocator(gpu_allocator const& c)
+    {
+        return *c.data;
+    }
+
+    // `gpu_allocation::pool` of dedicated allocation
+    static constexpr std::uint32_t dedicated_pool{ ~std::uint32_t{ 0 } };
+
+    struct block
+    {
+        vk::DeviceMemory memory{};
+        std::byte* mapped{ nullptr };
+        detail::tlsf ranges;
+    };
+
+    /*
+        blocks of one memory type,
+        each memory type has two pools: for buffers and linear images, and for optimal images,
+        so they never share a page of `bufferImageGranularity`
+
+        freed blocks leave `nullptr` behind, so indices in `gpu_allocation::block` stay valid
+    */
+    struct pool
+    {
+        std::uint32_t memory_type{ 0 };
+        std::vector<std::unique_ptr<block>> blocks;
+    };
+
+    // handle and dispatcher stay valid even if `device` is moved
+    vk::Device vk_device{};
+    vk::raii::detail::DeviceDispatcher const* dispatcher{ nullptr };
+    vk::PhysicalDeviceMemoryProperties memory_properties{};
+    vk::DeviceSize buffer_image_granularity{ 1 };
+    vk::DeviceSize block_size{ 0 };
+    std::vector<pool> pools;
+    std::uint64_t dedicated_bytes{ 0 };
+    std::uint32_t dedicated_count{ 0 };
+    std::unique_ptr<std::mutex> mutex{ std::make_unique<std::mutex>() };
+};
+
+struct pipeline_cache::impl
+{
+    static pipeline_cache::impl&
+    from_pipeline_cache(pipeline_cache& c)
+    {
+        return *c.data;
+    }
+
+    static pipeline_cache::impl const&
+    from_pipeline_cache(pipeline_cache const& c)
+    {
+        return *c.data;
+    }
+
+    vk::raii::PipelineCache vk_pipeline_cache{ nullptr };
+    // empty if cache isn't persisted
+    std::filesystem::path path;
+
+    // key of cache file
+    std::uint32_t vendor_id{ 0 };
+    std::uint32_t device_id{ 0 };
+    std::uint32_t driver_version{ 0 };
+    device_uuid pipeline_cache_uuid{};
+
+    bool warm{ false };
+};
+
+struct pipeline_compiler::impl
+{
+    static pipeline_compiler::impl&
+    from_compiler(pipeline_compiler& c)
+    {
+        return *c.data;
+    }
+
+    static pipeline_compiler::impl const&
+    from_compiler(pipeline_compiler const& c)
+    {
+        return *c.data;
+    }
+
+    struct entry
+    {
+        pipeline_status status{ pipeline_status::pending };
+        vk::Pipeline pipeline{};
+        std::string error;
+    };
+
+    // shared with compilation tasks, address is stable even if `pipeline_compiler` is moved
+    struct state
+    {
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::vector<entry> entries;
+    };
+
+    // handle and dispatcher stay valid even if `device` is moved
+    vk::Device vk_device{};
+    vk::raii::detail::DeviceDispatcher const* dispatcher{ nullptr };
+    vk::PipelineCache vk_pipeline_cache{};
+    std::unique_ptr<state> shared{ std::make_unique<state>() };
+    // declared last, so its threads are joined before anything else is destroyed
+    std::unique_ptr<detail::thread_pool> pool;
+};
+
+struct command_recorder::impl
+{
+    static command_recorder::impl&
+    from_recorder(command_recorder& c)
+    {
+        return *c.data;
+    }
+
+    static command_recorder::impl const&
+    from_recorder(command_recorder const& c)
+    {
+        return *c.data;
+    }
+
+    // used by one thread at a time
+    struct slot
+    {
+        vk::raii::CommandPool command_pool{ nullptr };
+        // allocated on demand, each `record` of frame takes the next one, they are reset with `command_pool`
+        std::vector<vk::raii::CommandBuffer> command_buffers;
+        std::size_t used{ 0 };
+    };
+
+    slot&
+    at(frame_index_type const frame, std::uint32_t const thread)
+    {
+        return slots[(std::size_t{ frame } * thread_count) + thread];
+    }
+
+    device::impl const* dev{ nullptr };
+    // `frames_in_flight * thread_count` slots, grouped by frame
+    std::vector<slot> slots;
+    std::uint32_t thread_count{ 0 };
+    frame_index_type current_frame{ 0 };
+    std::unique_ptr<detail::thread_pool> pool;
+};
+
+struct gpu_profiler::impl
+{
+    static gpu_profiler::impl&
+    from_profiler(gpu_profiler& c)
+    {
+        return *c.data;
+    }
+
+    static gpu_profiler::impl const&
+    from_profiler(gpu_profiler const& c)
+    {
+        return *c.data;
+    }
+
+    struct frame
+    {
+        // two timestamps per scope: begin at `2 * i`, end at `2 * i + 1`
+        vk::raii::QueryPool query_pool{ nullptr };
+        std::vector<std::string> names;
+        // incremented by scopes concurrently, may exceed `max_scopes`
+        std::unique_ptr<std::atomic<std::uint32_t>> used{ std::make_unique<std::atomic<std::uint32_t>>(0) };
+        // queries must not be read before their first reset
+        bool reset{ false };
+    };
+
+    // ring of samples of last `history_length` frames
+    struct history
+    {
+        std::vector<double> samples;
+        std::uint32_t next{ 0 };
+    };
+
+    std::vector<frame> frames;
+    std::map<std::string, history, std::less<>> scopes;
+    std::uint64_t timestamp_mask{ 0 };
+    double ns_per_tick{ 0 };
+    std::uint64_t dropped{ 0 };
+    std::uint32_t max_scopes{ 0 };
+    std::uint32_t history_length{ 0 };
+    frame_index_type current_frame{ 0 };
+    bool enabled{ false };
+};
+
+struct offscreen_target::impl
+{
+    static offscreen_target::impl&
+    from_offscreen_target(offscreen_target& c)
+    {
+        return *c.data;
+    }
+
+    static offscreen_target::impl const&
+    from_offscreen_target(offscreen_target const& c)
+    {
+        return *c.data;
+    }
+
+    device::impl const* dev{ nullptr };
+    // freed by `offscreen_target` after `image` is destroyed, empty if image is exportable or imported
+    gpu_allocation allocation{};
+    // memory of exportable or imported image, declared before `image`, so it is destroyed after it
+    vk::raii::DeviceMemory memory{ nullptr };
+    vk::raii::Image image{ nullptr };
+    vk::raii::ImageView view{ nullptr };
+    vk::DeviceSize memory_size{ 0 };
+    vk::Extent2D extent{};
+    vk::Format format{ vk::Format::eUndefined };
+    std::uint32_t memory_type_index{ 0 };
+};
+
+struct readback_stream::impl
+{
+    static readback_stream::impl&
+    from_readback_stream(readback_stream& c)
+    {
+        return *c.data;
+    }
+
+    static readback_stream::impl const&
+    from_readback_stream(readback_stream const& c)
+    {
+        return *c.data;
+    }
+
+    struct slot
+    {
+        vk::raii::CommandPool command_pool{ nullptr };
+        vk::raii::CommandBuffer command_buffer{ nullptr };
+        vk::raii::Buffer buffer{ nullptr };
+        // freed by `readback_stream` after `buffer` is destroyed
+        gpu_allocation allocation{};
+        vk::raii::Fence copied{ nullptr };
+        // copy is in flight or frame is being consumed
+        bool busy{ false };
+    };
+
+    // shared with worker thread, address is stable even if `readback_stream` is moved
+    struct state
+    {
+        vk::raii::Device const* vk_device{ nullptr };
+        gpu_allocator* allocator{ nullptr };
+        consumer consume;
+
+        std::mutex mutex;
+        std::condition_variable freed;
+        std::vector<slot> slots;
+        // the first failure of consumer, stream is stopped once it is set
+        std::string error;
+        readback_stats stats;
+    };
+
+    device::impl const* dev{ nullptr };
+    vk::Extent2D extent{};
+    vk::Format format{ vk::Format::eUndefined };
+    std::uint32_t next_slot{ 0 };
+    std::uint64_t next_index{ 0 };
+    std::unique_ptr<state> shared;
+    // declared last, so its thread is joined before anything else is destroyed
+    std::unique_ptr<detail::thread_pool> pool;
+};
+
+struct external_semaphore::impl
+{
+    static external_semaphore::impl&
+    from_external_semaphore(external_semaphore& c)
+    {
+        return *c.data;
+    }
+
+    static external_semaphore::impl const&
+    from_external_semaphore(external_semaphore const& c)
+    {
+        return *c.data;
+    }
+
+    vk::raii::Semaphore semaphore{ nullptr };
+    vk::ExternalSemaphoreHandleTypeFlagBits handle_type{ vk::ExternalSemaphoreHandleTypeFlagBits::eOpaqueFd };
+};
+
+struct timeline::impl
+{
+    static timeline::impl&
+    from_timeline(timeline& c)
+    {
+        return *c.data;
+    }
+
+    static timeline::impl const&
+    from_timeline(timeline const& c)
+    {
+        return *c.data;
+    }
+
+    /*
+        separately allocated, so it stays in place when `timeline` is moved
+        and can be shared by anything waiting for values (e.g. `deletion_queue`)
+    */
+    struct shared_state
+    {
+        vk::Device vk_device{};
+        vk::raii::detail::DeviceDispatcher const* dispatcher{ nullptr };
+        vk::Semaphore semaphore{};
+
+        std::atomic<value_type> next{ 0 };
+        // set to maximum, when semaphore is destroyed, gpu can't wait for it anymore
+        std::atomic<value_type> completed{ 0 };
+
+        // `semaphore` is destroyed under it, so it isn't destroyed while `poll` queries it
+        std::mutex mutex;
+    };
+
+    // cached value only grows, concurrent updates must not move it back
+    static void
+    update_cached(shared_state& s, value_type const value) noexcept
+    {
+        auto current{ s.completed.load(std::memory_order_relaxed) };
+        while (current < value && !s.completed.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /*
+        queries counter of semaphore and updates cached value,
+        it may be called concurrently with destruction of timeline
+    */
+    static value_type
+    poll(shared_state& s)
+    {
+        std::scoped_lock const lock{ s.mutex };
+
+        auto const cached{ s.completed.load(std::memory_order_relaxed) };
+        if (cached == std::numeric_limits<value_type>::max())
+        {
+            return cached;
+        }
+
+        auto const value{ s.vk_device.getSemaphoreCounterValue(s.semaphore, *s.dispatcher) };
+        update_cached(s, value);
+
+        return value;
+    }
+
+    vk::raii::Semaphore semaphore{ nullptr };
+    std::shared_ptr<shared_state> shared;
+};
+
+struct deletion_queue::impl
+{
+    static deletion_queue::impl&
+    from_deletion_queue(deletion_queue& c)
+    {
+        return *c.data;
+    }
+
+    static deletion_queue::impl const&
+    from_deletion_queue(deletion_queue const& c)
+    {
+        return *c.data;
+    }
+
+    struct entry
+    {
+        // keeps cached value alive even if timeline itself is destroyed
+        std::shared_ptr<timeline::impl::shared_state> source;
+        timeline::value_type value{ 0 };
+        std::shared_ptr<void> resource;
+    };
+
+    struct state
+    {
+        std::mutex mutex;
+        std::vector<entry> entries;
+    };
+
+    // for owners, which keep only shared state of timeline, e.g. because the timeline may be destroyed first
+    static void
+    push(deletion_queue& q, std::shared_ptr<timeline::impl::shared_state> source, timeline::value_type const value,
+         std::shared_ptr<void> resource)
+    {
+        auto& shared{ *q.data->shared };
+        std::scoped_lock const lock{ shared.mutex };
+
+        shared.entries.push_back({ .source = std::move(source), .value = value, .resource = std::move(resource) });
+    }
+
+    std::unique_ptr<state> shared;
+};
+
+struct descriptor_heap::impl
+{
+    static descriptor_heap::impl&
+    from_descriptor_heap(descriptor_heap& c)
+    {
+        return *c.data;
+    }
+
+    static descriptor_heap::impl const&
+    from_descriptor_heap(descriptor_heap const& c)
+    {
+        return *c.data;
+    }
+
+    // free indices of one binding, fresh ones are taken only when there are no freed ones
+    struct slots
+    {
+        std::uint32_t capacity{ 0 };
+        std::uint32_t next{ 0 };
+        std::vector<std::uint32_t> free;
+    };
+
+    // separately allocated, so slots can be released after `descriptor_heap` is moved
+    struct state
+    {
+        std::mutex mutex;
+        slots sampled_images;
+        slots storage_buffers;
+        slots samplers;
+
+        slots&
+        of(vk::DescriptorType const type)
+        {
+            switch (type)
+            {
+            case vk::DescriptorType::eSampledImage:
+                return sampled_images;
+            case vk::DescriptorType::eStorageBuffer:
+                return storage_buffers;
+            default:
+                return samplers;
+            }
+        }
+    };
+
+    // device parts, which stay valid even if device is moved
+    vk::Device vk_device{};
+    vk::raii::detail::DeviceDispatcher const* dispatcher{ nullptr };
+    deletion_queue* deletion{ nullptr };
+
+    vk::raii::DescriptorSetLayout set_layout{ nullptr };
+    vk::raii::DescriptorPool pool{ nullptr };
+    // freed together with `pool`
+    vk::DescriptorSet set{};
+    vk::raii::PipelineLayout pipeline_layout{ nullptr };
+    std::shared_ptr<state> shared;
+};
+
+struct indirect_draws::impl
+{
+    static indirect_draws::impl&
+    from_indirect_draws(indirect_draws& c)
+    {
+        return *c.data;
+    }
+
+    static indirect_draws::impl const&
+    from_indirect_draws(indirect_draws const& c)
+    {
+        return *c.data;
+    }
+
+    // storage buffer registered in `descriptors`, released on destruction
+    struct storage
+    {
+        storage(gpu_allocator& a, descriptor_heap& d) noexcept
+            : allocator{ &a }
+            , descriptors{ &d }
+        {
+        }
+
+        storage(storage&& other) noexcept
+            : allocator{ std::exchange(other.allocator, nullptr) }
+            , descriptors{ other.descriptors }
+            , buffer{ std::move(other.buffer) }
+            , allocation{ other.allocation }
+            , handle{ other.handle }
+        {
+        }
+
+        // released resources of `*this` are left to `other`, which releases them on its destruction
+        storage&
+        operator=(storage&& other) noexcept
+        {
+            using std::swap;
+
+            swap(allocator, other.allocator);
+            swap(descriptors, other.descriptors);
+            swap(buffer, other.buffer);
+            swap(allocation, other.allocation);
+            swap(handle, other.handle);
+
+            return *this;
+        }
+
+        ~storage()
+        {
+            if (!allocator)
+            {
+                return;
+            }
+
+            if (handle)
+            {
+                descriptors->remove(handle);
+            }
+
+            buffer.clear();
+            allocator->free(allocation);
+        }
+
+        gpu_allocator* allocator{ nullptr };
+        descriptor_heap* descriptors{ nullptr };
+        vk::raii::Buffer buffer{ nullptr };
+        gpu_allocation allocation{};
+        storage_buffer_handle handle{};
+    };
+
+    // count of draws, then `VkDrawIndexedIndirectCommand`s
+    static constexpr vk::DeviceSize count_size{ 16 };
+
+    descriptor_heap* descriptors{ nullptr };
+    deletion_queue* deletion{ nullptr };
+    std::uint32_t max_objects{ 0 };
+    frame_index_type current_frame{ 0 };
+    // frame timeline of renderer of the last `cull`, buffers are released once it reaches its last value
+    std::shared_ptr<timeline::impl::shared_state> frames;
+    std::optional<storage> objects;
+    // draws of each frame in flight
+    std::vector<storage> draws;
+    vk::raii::Pipeline pipeline{ nullptr };
+};
+
+struct uploader::impl
+{
+    static uploader::impl&
+    from_uploader(uploader& c)
+    {
+        return *c.data;
+    }
+
+    static uploader::impl const&
+    from_uploader(uploader const& c)
+    {
+        return *c.data;
+    }
+
+    struct buffer_copy
+    {
+        vk::Buffer dst{};
+        vk::BufferCopy region{};
+    };
+
+    struct image_copy
+    {
+        vk::Image dst{};
+        vk::BufferImageCopy region{};
+        vk::ImageLayout final_layout{};
+    };
+
+    struct batch
+    {
+        vk::raii::CommandPool command_pool{ nullptr };
+        vk::raii::CommandBuffer command_buffer{ nullptr };
+        // `0` until the first upload into batch
+        timeline::value_type value{ 0 };
+        // position of ring after the last byte used by batch
+        std::uint64_t ring_end{ 0 };
+        std::vector<buffer_copy> buffer_copies;
+        std::vector<image_copy> image_copies;
+    };
+
+    // separately allocated, so mutex stays in place when `uploader` is moved
+    struct state
+    {
+        std::mutex mutex;
+        // uploads since the last `flush`, they are recorded into command buffer only on submission
+        batch pending;
+        std::deque<batch> in_flight;
+        // finished batches, their command pools are reused
+        std::vector<batch> free;
+
+        timeline::value_type submitted{ 0 };
+        timeline::value_type acquired{ 0 };
+        // ownership transfers released by submitted batches, but not acquired yet
+        std::vector<device::impl::buffer_ownership_transfer> buffer_acquires;
+        std::vector<device::impl::image_ownership_transfer> image_acquires;
+
+        // monotonic positions in ring, offset in buffer is position modulo ring size
+        std::uint64_t head{ 0 };
+        std::uint64_t tail{ 0 };
+
+        upload_stats stats;
+    };
+
+    device::impl const* dev{ nullptr };
+    vk::raii::Buffer ring{ nullptr };
+    // freed by `uploader` after `ring` is destroyed
+    gpu_allocation ring_allocation{};
+    // `optimalBufferCopyOffsetAlignment`, image copies use multiple of it and of texel block size
+    vk::DeviceSize alignment{ 0 };
+    std::unique_ptr<timeline> done;
+    std::unique_ptr<state> shared;
+};
+
+struct asset_source::impl
+{
+    static asset_source::impl&
+    from_asset_source(asset_source& c)
+    {
+        return *c.data;
+    }
+
+    static asset_source::impl const&
+    from_asset_source(asset_source const& c)
+    {
+        return *c.data;
+    }
+
+    std::filesystem::path root;
+    std::unique_ptr<detail::thread_pool> pool;
+};
+
+struct asset_archive::impl
+{
+    static asset_archive::impl&
+    from_asset_archive(asset_archive& c)
+    {
+        return *c.data;
+    }
+
+    static asset_archive::impl const&
+    from_asset_archive(asset_archive const& c)
+    {
+        return *c.data;
+    }
+
+    // the whole archive, entries share it
+    asset file;
+    // views into `file`, sorted by name
+    std::span<detail::archive_entry const> entries;
+    std::string_view names;
 };
 
 } // namespace orbi
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace orbi::detail
+{
+
+/*
+    bounded lock-free queue with many producers and single consumer
+
+    each cell has sequence number, which tells whether it is free for producer with given position
+    or filled for consumer (Dmitry Vyukov's bounded queue), so producers synchronize
+    only on one `compare_exchange` of tail and never wait for each other or for consumer
+
+    values are filled and consumed in place, so `T` can be large without being copied
+
+    @pre `Capacity` is a power of two
+*/
+template <class T, std::size_t Capacity>
+struct mpsc_queue
+{
+public:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0);
+
+    mpsc_queue() noexcept
+    {
+        for (std::size_t i{ 0 }; i < Capacity; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpsc_queue(mpsc_queue const&) = delete;
+    mpsc_queue& operator=(mpsc_queue const&) = delete;
+
+    /*
+        may be called from any thread
+
+        `fill(T&)` must not throw, it is called with cell, which isn't visible to consumer yet
+
+        @return `false` if queue is full
+    */
+    template <class Fill>
+    bool
+    try_push(Fill&& fill) noexcept
+    {
+        auto position{ tail.load(std::memory_order_relaxed) };
+
+        while (true)
+        {
+            auto& c{ cells[position & mask] };
+            auto const sequence{ c.sequence.load(std::memory_order_acquire) };
+            auto const difference{ static_cast<std::int64_t>(sequence - position) };
+
+            if (difference == 0)
+            {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    fill(c.value);
+                    c.sequence.store(position + 1, std::memory_order_release);
+
+                    return true;
+                }
+            } else if (difference < 0)
+            {
+                // consumer hasn't freed the cell yet
+                return false;
+            } else
+            {
+                // other producer took this position
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /*
+        must be called only from one thread at a time
+
+        `consume(T&)` is called with the oldest filled cell, which is reused after it returns
+
+        @return `false` if queue is empty
+    */
+    template <class Consume>
+    bool
+    try_pop(Consume&& consume)
+    {
+        auto& c{ cells[head & mask] };
+        if (c.sequence.load(std::memory_order_acquire) != head + 1)
+        {
+            return false;
+        }
+
+        consume(c.value);
+        c.sequence.store(head + Capacity, std::memory_order_release);
+        ++head;
+
+        return true;
+    }
+
+private:
+    static constexpr std::uint64_t mask{ Capacity - 1 };
+
+    // `std::hardware_destructive_interference_size` isn't stable across compiler versions, so it isn't used in header
+    static constexpr std::size_t cache_line_size{ 64 };
+
+    struct cell
+    {
+        std::atomic<std::uint64_t> sequence{ 0 };
+        T value{};
+    };
+
+    std::array<cell, Capacity> cells;
+
+    // producers and consumer don't share cache line
+    alignas(cache_line_size) std::atomic<std::uint64_t> tail{ 0 };
+    alignas(cache_line_size) std::uint64_t head{ 0 };
+};
+
+} // namespace orbi::detail
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace orbi::detail
+{
+
+/*
+    fixed number of worker threads executing tasks in submission order
+
+    tasks must not throw, exception escaping task terminates program
+*/
+struct thread_pool
+{
+public:
+    using task_type = std::function<void()>;
+
+    /*
+        `0` means `std::thread::hardware_concurrency() - 1`, but at least one thread
+
+        @throw `std::system_error` if thread can't be started, already started ones are joined
+    */
+    explicit thread_pool(std::uint32_t thread_count = 0);
+
+    /*
+        finishes all already submitted tasks and joins threads
+    */
+    ~thread_pool();
+
+    thread_pool(thread_pool const&) = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+
+    void submit(task_type);
+
+    /*
+        blocks until all submitted tasks are finished
+    */
+    void wait_until_idle();
+
+    std::uint32_t thread_count() const noexcept;
+
+private:
+    void run();
+
+    // wakes threads, which finish submitted tasks, and joins them
+    void stop() noexcept;
+
+    std::mutex mutex;
+    std::condition_variable task_available;
+    std::condition_variable idle;
+    std::deque<task_type> tasks;
+    std::uint32_t running{ 0 };
+    bool stopping{ false };
+    std::vector<std::thread> threads;
+};
+
+} // namespace orbi::detail
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace orbi::detail
+{
+
+/*
+    two-level segregated fit allocator of offsets inside `[0, capacity)`
+
+    it doesn't touch memory it manages, so it can be used for gpu memory,
+    bookkeeping lives in separate nodes
+
+    both `allocate` and `free` are O(1): free ranges are kept in lists segregated by size class,
+    classes are found with bit scans of two bitmaps
+*/
+struct tlsf
+{
+public:
+    using size_type = std::uint64_t;
+    using node_index_type = std::uint32_t;
+
+    struct allocation
+    {
+        size_type offset{ 0 };
+        size_type size{ 0 };
+        node_index_type node{ 0 };
+    };
+
+    explicit tlsf(size_type capacity);
+
+    /*
+        @pre `alignment` is a power of two
+        @return `std::nullopt` if there is no free range large enough
+    */
+    std::optional<allocation> allocate(size_type size, size_type alignment = 1);
+
+    /*
+        @pre `a` was returned by `allocate` of `*this` and wasn't freed yet
+    */
+    void free(allocation const& a) noexcept;
+
+    size_type capacity() const noexcept;
+    size_type used() const noexcept;
+    size_type largest_free() const noexcept;
+    std::uint32_t allocation_count() const noexcept;
+    std::uint32_t free_range_count() const noexcept;
+
+    bool
+    empty() const noexcept
+    {
+        return allocation_count() == 0;
+    }
+
+private:
+    static constexpr node_index_type npos{ ~node_index_type{ 0 } };
+
+    static constexpr unsigned sl_log2{ 5 };
+    static constexpr unsigned sl_count{ 1u << sl_log2 };
+    static constexpr unsigned fl_count{ 64 - sl_log2 + 1 };
+
+    struct node
+    {
+        size_type offset{ 0 };
+        size_type size{ 0 };
+        node_index_type prev_physical{ npos };
+        node_index_type next_physical{ npos };
+        node_index_type prev_free{ npos };
+        node_index_type next_free{ npos };
+        bool free{ false };
+    };
+
+    struct size_class
+    {
+        unsigned fl{ 0 };
+        unsigned sl{ 0 };
+    };
+
+    static size_class class_of(size_type size) noexcept;
+    // @return the first class starting with `c`, which has free ranges
+    std::optional<size_class> first_non_empty_class(size_class c) const noexcept;
+    std::optional<size_class> find_suitable_class(size_type size) const noexcept;
+    // scans free ranges of non-empty classes starting with class of `size`
+    node_index_type find_in_class(size_type size, size_type alignment) const noexcept;
+
+    node_index_type make_node();
+    void release_node(node_index_type) noexcept;
+
+    void insert_free(node_index_type) noexcept;
+    void remove_free(node_index_type) noexcept;
+
+    /*
+        splits node at `offset` relative to node start
+        @return index of the second part
+    */
+    node_index_type split(node_index_type, size_type at);
+
+    // absorbs physically next node `next` into `n`
+    void merge(node_index_type n, node_index_type next) noexcept;
+
+    size_type total_size{ 0 };
+    size_type used_size{ 0 };
+    std::uint32_t allocations{ 0 };
+    std::uint32_t free_ranges{ 0 };
+
+    std::vector<node> nodes;
+    std::vector<node_index_type> unused_nodes;
+
+    std::uint64_t fl_bitmap{ 0 };
+    std::array<std::uint32_t, fl_count> sl_bitmaps{};
+    std::array<std::array<node_index_type, sl_count>, fl_count> free_heads;
+};
+
+} // namespace orbi::detail
@@ -1,19 +1,129 @@
 #pragma once
 
+#include <orbi/descriptor_heap.hpp>
 #include <orbi/detail/pimpl.hpp>
 #include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
 
 #include <vulkan/vulkan_raii.hpp>
 
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace orbi
 {
 
 struct window;
 struct context;
+struct gpu_allocator;
+struct pipeline_cache;
+struct deletion_queue;
+
+using device_uuid = std::array<std::uint8_t, VK_UUID_SIZE>;
+
+struct device_options
+{
+    // in addition to extensions, which are always needed by `orbi` (e.g. `VK_KHR_swapchain` unless headless)
+    std::vector<std::string> required_extensions;
+    vk::PhysicalDeviceFeatures required_features{};
+
+    /*
+        explicit choice of physical device, bypasses scoring,
+        but device still must be suitable
+
+        name matches if it's a substring of device name
+    */
+    std::optional<std::string> preferred_name;
+    std::optional<device_uuid> preferred_uuid;
+
+    /*
+        name of environment variable with device name or uuid (hex, dashes are ignored),
+        takes precedence over `preferred_name` and `preferred_uuid`
+
+        empty string disables it
+    */
+    std::string override_env{ "ORBI_DEVICE" };
+
+    /*
+        directory where pipeline cache is loaded from and saved to,
+        empty path keeps cache in memory only
+    */
+    std::filesystem::path pipeline_cache_directory;
+
+    /*
+        requires and enables `VK_KHR_external_memory_fd` and `VK_KHR_external_semaphore_fd`,
+        so images and semaphores can be shared with other processes, see `orbi/external.hpp`
+    */
+    bool external_memory{ false };
+
+    /*
+        requires and enables descriptor indexing with update after bind,
+        which `descriptor_heap` is built on, and creates heap of device, see `device::descriptors`
+    */
+    bool bindless{ false };
+    descriptor_heap_capacity descriptor_capacity{};
+
+    /*
+        requires and enables `drawIndirectCount`, `multiDrawIndirect` and `drawIndirectFirstInstance`,
+        which `indirect_draws` is built on
+    */
+    bool indirect_draw{ false };
+};
+
+struct device_candidate
+{
+    std::string name;
+    device_uuid uuid{};
+    vk::PhysicalDeviceType type{ vk::PhysicalDeviceType::eOther };
+
+    // bigger is better, `0` for rejected candidate
+    std::uint64_t score{ 0 };
+    std::vector<std::string> rejection_reasons;
+
+    bool
+    suitable() const noexcept
+    {
+        return rejection_reasons.empty();
+    }
+};
+
+enum class queue_type
+{
+    graphics,
+    present,
+    compute,
+    transfer,
+};
 
 struct device
 {
-    device(context const&, window const&);
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    /*
+        selects physical device with the best score:
+        device type first, then size of device local memory
+
+        @throw `device::error` if there is no suitable device
+               or there is no suitable device matching explicit override
+    */
+    device(context const&, window const&, device_options const& = {});
+
+    /*
+        headless device, which can't present, so it's selected without any surface
+
+        present queue is the graphics one and `VK_KHR_swapchain` isn't enabled,
+        rendering targets `offscreen_target` instead of `swapchain`
+
+        @throw `device::error` the same as constructor with window
+    */
+    explicit device(context const&, device_options const& = {});
     ~device();
 
     device(device&&) noexcept;
@@ -21,13 +131,73 @@ struct device
 
     friend void swap(device&, device&) noexcept;
 
+    /*
+        @return all physical devices with their scores and rejection reasons,
+                sorted from best to worst
+
+        @throw `device::error`
+    */
+    static std::vector<device_candidate> candidates(context const&, window const&,
+                                                    device_options const& = {});
+    // candidates for headless device
+    static std::vector<device_candidate> candidates(context const&, device_options const& = {});
+
     void wait_until_idle() const;
 
+    /*
+        @return `true` if queue of `type` is from other family than graphics one,
+                i.e. work submitted to it can overlap graphics work
+
+        queues, which have no dedicated family, fall back to other queues of graphics family,
+        and to graphics queue itself if the family has only one queue
+    */
+    bool has_dedicated_queue(queue_type) const noexcept;
+
+    // @return `true` if `*this` was created without window
+    bool headless() const noexcept;
+
+    // @return `true` if `*this` was created with `device_options::external_memory`
+    bool external_memory() const noexcept;
+
+    // @return `true` if `*this` was created with `device_options::bindless`
+    bool bindless() const noexcept;
+
+    // @return `true` if `*this` was created with `device_options::indirect_draw`
+    bool indirect_draw() const noexcept;
+
+    /*
+        allocator of device memory, owned by `*this`
+    */
+    gpu_allocator& allocator() const noexcept;
+
+    /*
+        pipeline cache of device, owned by `*this`,
+        it is saved on destruction of `*this`
+    */
+    pipeline_cache& cache() const noexcept;
+
+    /*
+        resources waiting until gpu is done with them, owned by `*this`,
+        remaining ones are destroyed on destruction of `*this`
+    */
+    deletion_queue& deletion() const noexcept;
+
+    /*
+        bindless descriptors of device, owned by `*this`
+
+        @pre `*this` was created with `device_options::bindless`
+    */
+    descriptor_heap& descriptors() const noexcept;
+
     struct impl;
     friend impl;
 
 private:
-    detail::pimpl<impl, 48, 8> data;
+    // null `surface` means headless device
+    device(context const&, VkSurfaceKHR surface, device_options const&);
+    static std::vector<device_candidate> candidates(context const&, VkSurfaceKHR surface, device_options const&);
+
+    detail::pimpl<impl, 176, 8> data;
 };
 
 } // namespace orbi
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/device.hpp>
+#include <orbi/exception.hpp>
+#include <orbi/rendering.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+
+namespace orbi
+{
+
+/*
+    everything other process needs to import image exported by `offscreen_target::export_image`
+
+    memory is exported as opaque fd, so importer must use the same physical device and driver,
+    which is checked by `physical_device_uuid` and `driver_uuid`
+
+    all members are trivially copyable, so description can be sent as is, e.g. over unix socket,
+    `memory_fd` itself must be passed as file descriptor (`SCM_RIGHTS`) and replaced on receiving side
+*/
+struct external_image
+{
+    int memory_fd{ -1 };
+    vk::DeviceSize memory_size{ 0 };
+    std::uint32_t memory_type_index{ 0 };
+
+    vk::Extent2D extent{};
+    vk::Format format{ vk::Format::eUndefined };
+
+    device_uuid physical_device_uuid{};
+    device_uuid driver_uuid{};
+};
+
+/*
+    binary semaphore, which can be shared with other process
+
+    handle type is `vk::ExternalSemaphoreHandleTypeFlagBits::eSyncFd` if device can export and import it,
+    otherwise `eOpaqueFd`, processes on the same device and driver choose the same one
+*/
+struct external_semaphore
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    /*
+        @pre `dev` was created with `device_options::external_memory`
+        @pre `dev` must outlive `*this`
+        @throw `external_semaphore::error`
+    */
+    explicit external_semaphore(device const&);
+    ~external_semaphore();
+
+    external_semaphore(external_semaphore&&) noexcept;
+    external_semaphore& operator=(external_semaphore);
+
+    friend void swap(external_semaphore&, external_semaphore&) noexcept;
+
+    vk::Semaphore semaphore() const noexcept;
+    vk::ExternalSemaphoreHandleTypeFlagBits handle_type() const noexcept;
+
+    /*
+        @return new file descriptor owned by caller
+
+        sync fd refers to the last submitted signal and must be exported after each signal,
+        opaque fd refers to semaphore itself and is enough to export once
+
+        @pre for sync fd, signal operation is already submitted
+        @throw `external_semaphore::error`
+    */
+    int export_fd() const;
+
+    /*
+        takes ownership of `fd` on success
+
+        sync fd is imported temporarily, i.e. only for the next wait,
+        opaque fd replaces payload of semaphore permanently
+
+        @throw `external_semaphore::error`
+    */
+    void import_fd(int fd);
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 40, 8> data;
+};
+
+/*
+    records release of `image` from graphics queue family of `dev` to `VK_QUEUE_FAMILY_EXTERNAL`,
+    changing its layout from `from.layout` to `layout`
+
+    importer must record `acquire_from_external` with the same `layout`
+    in submission, which waits for semaphore signaled after release
+*/
+void release_to_external(device const&, vk::raii::CommandBuffer const&, vk::Image, image_state const& from,
+                         vk::ImageLayout layout);
+
+/*
+    records acquire of `image` from `VK_QUEUE_FAMILY_EXTERNAL` to graphics queue family of `dev`,
+    changing its layout from `layout`, which was passed to `release_to_external`, to `to.layout`
+*/
+void acquire_from_external(device const&, vk::raii::CommandBuffer const&, vk::Image, vk::ImageLayout layout,
+                           image_state const& to);
+
+} // namespace orbi
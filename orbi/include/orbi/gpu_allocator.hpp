@@ -0,0 +1,136 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstddef>
+
+namespace orbi
+{
+
+struct device;
+
+enum class memory_usage
+{
+    // device local if possible, not mapped
+    gpu_only,
+    // host visible and coherent, persistently mapped, for cpu writes which gpu reads
+    upload,
+    // host visible and coherent, preferably cached, persistently mapped, for gpu writes which cpu reads
+    readback,
+};
+
+struct gpu_allocation_info
+{
+    vk::MemoryRequirements requirements{};
+    memory_usage usage{ memory_usage::gpu_only };
+
+    /*
+        must be `true` for images with optimal tiling,
+        they must not share `bufferImageGranularity` page with buffers and linear images
+    */
+    bool optimal_image{ false };
+
+    /*
+        forces separate `VkDeviceMemory`, e.g. when `VkMemoryDedicatedRequirements` prefers it,
+        allocations larger than half of a block are always dedicated
+
+        if set, at most one of `dedicated_buffer` and `dedicated_image` may be set as well
+    */
+    bool dedicated{ false };
+    vk::Buffer dedicated_buffer{};
+    vk::Image dedicated_image{};
+};
+
+struct gpu_allocation
+{
+    vk::DeviceMemory memory{};
+    vk::DeviceSize offset{ 0 };
+    vk::DeviceSize size{ 0 };
+
+    // already offset by `offset`, `nullptr` if memory isn't host visible
+    std::byte* mapped{ nullptr };
+
+    // bookkeeping of `gpu_allocator`, meaningless for users
+    std::uint32_t pool{ 0 };
+    std::uint32_t block{ 0 };
+    std::uint32_t node{ 0 };
+
+    explicit operator bool() const noexcept
+    {
+        return static_cast<bool>(memory);
+    }
+};
+
+struct gpu_allocator_stats
+{
+    std::uint64_t used_bytes{ 0 };
+    // size of all `VkDeviceMemory` objects, including dedicated
+    std::uint64_t reserved_bytes{ 0 };
+    std::uint32_t block_count{ 0 };
+    std::uint32_t dedicated_count{ 0 };
+    std::uint32_t allocation_count{ 0 };
+    std::uint64_t largest_free_range{ 0 };
+
+    /*
+        `1 - (sum of largest free ranges of blocks) / (free bytes in blocks)`
+
+        `0` means free memory of each block is one contiguous range
+    */
+    float fragmentation{ 0 };
+};
+
+/*
+    sub-allocating gpu memory allocator
+
+    large blocks are allocated per memory type and sub-allocated with `detail::tlsf`,
+    so number of `VkDeviceMemory` objects stays far below `maxMemoryAllocationCount`
+
+    host visible blocks are persistently mapped
+
+    all member functions are thread safe
+*/
+struct gpu_allocator
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    static constexpr vk::DeviceSize default_block_size{ 64 * 1024 * 1024 };
+
+    /*
+        @pre `dev` must outlive `*this`
+    */
+    explicit gpu_allocator(device const&, vk::DeviceSize block_size = default_block_size);
+    ~gpu_allocator();
+
+    gpu_allocator(gpu_allocator&&) noexcept;
+    gpu_allocator& operator=(gpu_allocator);
+
+    friend void swap(gpu_allocator&, gpu_allocator&) noexcept;
+
+    /*
+        @throw `gpu_allocator::error`
+    */
+    gpu_allocation allocate(gpu_allocation_info const&);
+
+    /*
+        @pre `a` was returned by `allocate` of `*this`, or is empty
+    */
+    void free(gpu_allocation const& a) noexcept;
+
+    gpu_allocator_stats stats() const;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 600, 8> data;
+};
+
+} // namespace orbi
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+#include <orbi/renderer.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace orbi
+{
+
+struct device;
+
+struct gpu_scope_stats
+{
+    std::string name;
+
+    // over last `history_length` frames, scopes with the same name within one frame are summed
+    double min_ms{ 0 };
+    double avg_ms{ 0 };
+    double max_ms{ 0 };
+    std::uint32_t sample_count{ 0 };
+};
+
+/*
+    measures gpu time of named scopes with timestamp queries
+
+    every frame in flight has its own query pool, results of frame are read
+    when the same frame begins again, i.e. after `renderer::begin_frame` waited for it,
+    so reading never stalls
+
+    if graphics queue doesn't support timestamps, scopes record nothing
+*/
+struct gpu_profiler
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    using frame_index_type = renderer::frame_index_type;
+
+    static constexpr std::uint32_t default_max_scopes{ 256 };
+    static constexpr std::uint32_t default_history_length{ 64 };
+
+    /*
+        @pre `dev` must outlive `*this`
+        @throw `gpu_profiler::error`
+    */
+    gpu_profiler(device const&, frame_index_type frames_in_flight,
+                 std::uint32_t max_scopes_per_frame = default_max_scopes,
+                 std::uint32_t history_length = default_history_length);
+    ~gpu_profiler();
+
+    gpu_profiler(gpu_profiler&&) noexcept;
+    gpu_profiler& operator=(gpu_profiler);
+
+    friend void swap(gpu_profiler&, gpu_profiler&) noexcept;
+
+    /*
+        collects results of previous use of current frame of `r`,
+        and records reset of its queries into `command_buffer`
+
+        @pre `r.begin_frame()` was called
+        @pre `command_buffer` is recording and is submitted before any command buffer with scopes of this frame
+        @pre scopes of previous use of this frame are destroyed
+        @throw `gpu_profiler::error`
+    */
+    void begin_frame(renderer const& r, vk::raii::CommandBuffer const& command_buffer);
+
+    /*
+        @return statistics of all scopes, sorted by name
+    */
+    std::vector<gpu_scope_stats> stats() const;
+
+    // number of scopes, which didn't fit into `max_scopes_per_frame` since construction
+    std::uint64_t dropped_scopes() const noexcept;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 112, 8> data;
+};
+
+/*
+    writes timestamps at construction and destruction
+
+    scopes may be created concurrently on different threads (e.g. in `command_recorder`)
+
+    @pre `profiler` and `command_buffer` must outlive `*this`
+*/
+struct gpu_scope
+{
+public:
+    gpu_scope(gpu_profiler& profiler, vk::raii::CommandBuffer const& command_buffer, std::string_view name);
+    ~gpu_scope();
+
+    gpu_scope(gpu_scope const&) = delete;
+    gpu_scope& operator=(gpu_scope const&) = delete;
+
+private:
+    gpu_profiler* profiler{ nullptr };
+    vk::raii::CommandBuffer const* command_buffer{ nullptr };
+    gpu_profiler::frame_index_type frame{ 0 };
+    std::uint32_t query{ 0 };
+    bool active{ false };
+};
+
+} // namespace orbi
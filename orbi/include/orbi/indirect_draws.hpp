@@ -0,0 +1,138 @@
+#pragma once
+
+#include <orbi/descriptor_heap.hpp>
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+#include <orbi/renderer.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace orbi
+{
+
+struct device;
+
+/*
+    one indexed draw, layout matches std430 struct in culling shader
+*/
+struct draw_object
+{
+    // bounding sphere in the same space as `frustum`: center and radius
+    std::array<float, 4> sphere{};
+
+    std::uint32_t index_count{ 0 };
+    std::uint32_t first_index{ 0 };
+    std::int32_t vertex_offset{ 0 };
+
+    // `firstInstance` of draw, so it's `gl_InstanceIndex`, e.g. index of per object data
+    std::uint32_t instance{ 0 };
+};
+
+static_assert(sizeof(draw_object) == 32);
+
+/*
+    planes with normals pointing inside, point `p` is inside if `dot(normal, p) + distance >= 0` for each one
+*/
+struct frustum
+{
+    // normal and distance: left, right, bottom, top, near, far
+    std::array<std::array<float, 4>, 6> planes{};
+};
+
+/*
+    @param view_projection column major matrix with vulkan clip space (depth from `0` to `1`)
+    @return frustum in space transformed by `view_projection`, e.g. world space
+*/
+frustum make_frustum(std::array<float, 16> const& view_projection) noexcept;
+
+/*
+    gpu driven draws: objects live in gpu buffer, compute shader culls them against frustum
+    and writes `VkDrawIndexedIndirectCommand` of visible ones with their count,
+    which one `vkCmdDrawIndexedIndirectCount` consumes, so cpu cost doesn't grow with number of objects
+
+    buffers are storage buffers of `device::descriptors()`
+
+    per frame:
+
+        draws.update(command_buffer, first, changed_objects); // if any
+        draws.cull(renderer, command_buffer, frustum, object_count);
+        // begin rendering, bind pipeline with `device::descriptors().pipeline_layout()`, index and vertex buffers
+        draws.draw(command_buffer);
+*/
+struct indirect_draws
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    using frame_index_type = renderer::frame_index_type;
+
+    static constexpr std::uint32_t workgroup_size{ 64 };
+
+    /*
+        @pre `dev` was created with `device_options::bindless` and `device_options::indirect_draw`
+        @pre `dev` must outlive `*this`
+        @pre `frames_in_flight > 0`
+        @pre `max_objects > 0`
+        @throw `indirect_draws::error`
+    */
+    indirect_draws(device const&, frame_index_type frames_in_flight, std::uint32_t max_objects);
+
+    /*
+        buffers are released by `device::deletion()` once frames, which culled with them, are finished
+
+        @pre command buffers with `update`, but without `cull`, are finished
+    */
+    ~indirect_draws();
+
+    indirect_draws(indirect_draws&&) noexcept;
+    indirect_draws& operator=(indirect_draws);
+
+    friend void swap(indirect_draws&, indirect_draws&) noexcept;
+
+    /*
+        records copy of `objects` to objects starting with `first`,
+        it is ordered with culling of earlier and later frames, so objects may be updated while frames are in flight
+
+        data is embedded in command buffer, so it's meant for changed objects, not for all of them every frame
+
+        @pre `first + objects.size() <= max_objects()`
+        @pre called outside of rendering
+    */
+    void update(vk::raii::CommandBuffer const&, std::uint32_t first, std::span<draw_object const> objects) const;
+
+    /*
+        records culling of objects `[0, count)` into draws of the current frame of `r`
+
+        @pre `count <= max_objects()`
+        @pre called outside of rendering
+    */
+    void cull(renderer const& r, vk::raii::CommandBuffer const&, frustum const&, std::uint32_t count);
+
+    /*
+        records draw of objects, which passed the last `cull`
+
+        @pre pipeline, index and vertex buffers are bound
+    */
+    void draw(vk::raii::CommandBuffer const&) const;
+
+    std::uint32_t max_objects() const noexcept;
+
+    // buffer of `draw_object`s, e.g. for vertex shader
+    storage_buffer_handle objects() const noexcept;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 208, 8> data;
+};
+
+} // namespace orbi
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+namespace orbi
+{
+
+struct device;
+struct external_image;
+
+/*
+    color image with its view, which is rendered to instead of swapchain image,
+    e.g. by headless device
+
+    image can be rendered to, copied from (to read pixels back) and sampled,
+    its memory is allocated from allocator of device
+
+    there is no acquire and present, so frame is submitted without semaphores
+    and image is ordered between frames by `image_states::discarded`
+*/
+struct offscreen_target
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    static constexpr vk::Format default_format{ vk::Format::eR8G8B8A8Unorm };
+
+    /*
+        exportable image has its own dedicated memory, which can be shared with other process by `export_image`
+
+        @pre `dev` must outlive `*this`
+        @pre `extent` isn't empty
+        @pre if `exportable`, `dev` was created with `device_options::external_memory`
+        @throw `offscreen_target::error`
+    */
+    offscreen_target(device const&, vk::Extent2D extent, vk::Format format = default_format,
+                     bool exportable = false);
+
+    ~offscreen_target();
+
+    offscreen_target(offscreen_target&&) noexcept;
+    offscreen_target& operator=(offscreen_target);
+
+    friend void swap(offscreen_target&, offscreen_target&) noexcept;
+
+    vk::Image image() const noexcept;
+    vk::ImageView view() const noexcept;
+    vk::Extent2D extent() const noexcept;
+    vk::Format format() const noexcept;
+
+    /*
+        @return description with new file descriptor of memory, owned by caller
+
+        @pre `*this` is exportable
+        @throw `offscreen_target::error`
+    */
+    external_image export_image() const;
+
+    /*
+        imports image exported by other process, always takes ownership of `image.memory_fd`,
+        it's closed on failure too, so caller never closes it
+
+        image contents are undefined until it is acquired with `acquire_from_external`
+
+        @pre `dev` was created with `device_options::external_memory`
+        @pre `dev` must outlive returned target
+        @throw `offscreen_target::error`, also if `image` was exported by other device or driver
+    */
+    static offscreen_target import_image(device const&, external_image const& image);
+
+    struct impl;
+    friend impl;
+
+private:
+    offscreen_target() = default;
+
+    detail::pimpl<impl, 176, 8> data;
+};
+
+} // namespace orbi
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <filesystem>
+
+namespace orbi
+{
+
+struct device;
+
+/*
+    `VkPipelineCache` persisted on disk
+
+    file is keyed by vendor, device, driver version and `pipelineCacheUUID`,
+    so several gpus or drivers never overwrite each other's caches,
+    and header of file is validated before data is handed to driver
+*/
+struct pipeline_cache
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    /*
+        loads cache from `directory`, if it has valid cache for `dev`,
+        otherwise cache starts empty
+
+        empty `directory` means cache isn't persisted at all
+
+        @pre `dev` must outlive `*this`
+        @throw `pipeline_cache::error`
+    */
+    pipeline_cache(device const&, std::filesystem::path const& directory);
+
+    /*
+        saves cache, errors are ignored
+    */
+    ~pipeline_cache();
+
+    pipeline_cache(pipeline_cache&&) noexcept;
+    pipeline_cache& operator=(pipeline_cache);
+
+    friend void swap(pipeline_cache&, pipeline_cache&) noexcept;
+
+    /*
+        atomically replaces cache file with current content of cache
+
+        @throw `pipeline_cache::error`
+    */
+    void save() const;
+
+    /*
+        @return `true` if cache was loaded from disk
+    */
+    bool warm() const noexcept;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 104, 8> data;
+};
+
+} // namespace orbi
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace orbi
+{
+
+struct device;
+
+struct shader_stage_description
+{
+    // SPIR-V
+    std::span<std::uint32_t const> code;
+    // keeps `code` alive until compilation is finished (e.g. `asset::storage`), may be null if `code` is static
+    std::shared_ptr<void const> storage;
+    std::string entry_point{ "main" };
+};
+
+/*
+    everything needed to create graphics pipeline, owned by value (or shared in case of SPIR-V),
+    so it can be compiled on other thread after caller's state is gone
+
+    viewport and scissor are always dynamic
+*/
+struct graphics_pipeline_description
+{
+    shader_stage_description vertex;
+    shader_stage_description fragment;
+
+    std::vector<vk::VertexInputBindingDescription> vertex_bindings;
+    std::vector<vk::VertexInputAttributeDescription> vertex_attributes;
+
+    vk::PrimitiveTopology topology{ vk::PrimitiveTopology::eTriangleList };
+    vk::PolygonMode polygon_mode{ vk::PolygonMode::eFill };
+    vk::CullModeFlags cull_mode{ vk::CullModeFlagBits::eBack };
+    vk::FrontFace front_face{ vk::FrontFace::eClockwise };
+
+    // one per color attachment
+    std::vector<vk::PipelineColorBlendAttachmentState> color_blend_attachments{ vk::PipelineColorBlendAttachmentState{
+        .blendEnable = vk::False,
+        .colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                          vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA } };
+
+    /*
+        formats of attachments of dynamic rendering, pipeline isn't tied to any render pass object
+
+        @pre `color_formats.size() == color_blend_attachments.size()`
+    */
+    std::vector<vk::Format> color_formats;
+    // depth test and write with `vk::CompareOp::eLess` are enabled if it is set
+    vk::Format depth_format{ vk::Format::eUndefined };
+
+    // @pre must outlive compilation
+    vk::PipelineLayout layout{};
+};
+
+struct compute_pipeline_description
+{
+    shader_stage_description shader;
+
+    // @pre must outlive compilation
+    vk::PipelineLayout layout{};
+};
+
+enum class pipeline_status
+{
+    pending,
+    ready,
+    failed,
+};
+
+struct pipeline_handle
+{
+    static constexpr std::uint32_t invalid_index{ ~std::uint32_t{ 0 } };
+
+    std::uint32_t index{ invalid_index };
+
+    explicit operator bool() const noexcept
+    {
+        return index != invalid_index;
+    }
+};
+
+/*
+    compiles pipelines on worker threads using pipeline cache of device,
+    so driver compilation never blocks thread, which records frames
+
+    compiled pipelines are owned by `*this`
+
+    all member functions are thread safe
+*/
+struct pipeline_compiler
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    /*
+        `thread_count == 0` means `std::thread::hardware_concurrency() - 1`, but at least one thread
+
+        @pre `dev` must outlive `*this`
+    */
+    explicit pipeline_compiler(device const&, std::uint32_t thread_count = 0);
+
+    /*
+        waits for pending compilations and destroys all pipelines
+
+        @pre pipelines aren't used by gpu anymore
+    */
+    ~pipeline_compiler();
+
+    pipeline_compiler(pipeline_compiler&&) noexcept;
+    pipeline_compiler& operator=(pipeline_compiler);
+
+    friend void swap(pipeline_compiler&, pipeline_compiler&) noexcept;
+
+    /*
+        queues compilation and returns immediately
+    */
+    pipeline_handle compile(graphics_pipeline_description);
+    pipeline_handle compile(compute_pipeline_description);
+
+    pipeline_status status(pipeline_handle) const;
+
+    /*
+        @return pipeline or null handle if it isn't ready (yet)
+    */
+    vk::Pipeline get(pipeline_handle) const;
+
+    /*
+        @return pipeline of `h` if it is ready, otherwise pipeline of `fallback` (which may be null handle as well)
+    */
+    vk::Pipeline get_or(pipeline_handle h, pipeline_handle fallback) const;
+
+    /*
+        blocks until compilation of `h` is finished
+
+        @throw `pipeline_compiler::error` if compilation failed
+    */
+    vk::Pipeline wait(pipeline_handle h) const;
+
+    /*
+        blocks until all queued compilations are finished
+    */
+    void wait_until_idle() const;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 40, 8> data;
+};
+
+} // namespace orbi
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+#include <orbi/rendering.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+namespace orbi
+{
+
+struct device;
+struct offscreen_target;
+
+struct readback_frame
+{
+    // number of `push`, which copied this frame, starting from `0`
+    std::uint64_t index{ 0 };
+    vk::Extent2D extent{};
+    vk::Format format{ vk::Format::eUndefined };
+
+    // tightly packed rows, valid only during call of consumer
+    std::span<std::byte const> pixels;
+};
+
+struct readback_stats
+{
+    std::uint64_t frames_consumed{ 0 };
+    std::uint64_t bytes_consumed{ 0 };
+
+    // number of `push` calls, which had to wait for consumer to free a buffer
+    std::uint64_t stalls{ 0 };
+};
+
+/*
+    pipelined copy of rendered images to cpu
+
+    each `push` copies image to the next buffer of ring of persistently mapped readback buffers
+    and submits the copy with its own fence, worker thread waits for that fence
+    and passes frame to consumer in order of `push`
+
+    so cpu waits for gpu only when all buffers of ring are still in flight or being consumed,
+    and frame reaches consumer `depth - 1` pushes later in the worst case
+*/
+struct readback_stream
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    /*
+        called on worker thread, exception thrown by it stops the stream
+        and is reported by next `push` or `flush`
+    */
+    using consumer = std::function<void(readback_frame const&)>;
+
+    static constexpr std::uint32_t default_depth{ 3 };
+
+    /*
+        @pre `dev` must outlive `*this`
+        @pre `format` isn't compressed
+        @pre `depth > 0`
+        @throw `readback_stream::error`
+    */
+    readback_stream(device const&, vk::Extent2D extent, vk::Format format, consumer,
+                    std::uint32_t depth = default_depth);
+
+    /*
+        waits until all pushed frames are consumed
+    */
+    ~readback_stream();
+
+    readback_stream(readback_stream&&) noexcept;
+    readback_stream& operator=(readback_stream);
+
+    friend void swap(readback_stream&, readback_stream&) noexcept;
+
+    /*
+        copies `image` on graphics queue, image is left in `image_states::transfer_source`
+
+        @pre submission, which renders to `image`, is already submitted to graphics queue
+        @pre `image` has extent and format of `*this` and is in `state`
+        @throw `readback_stream::error`, also if consumer failed
+    */
+    void push(vk::Image image, image_state const& state = image_states::color_attachment);
+    void push(offscreen_target const&, image_state const& state = image_states::color_attachment);
+
+    /*
+        blocks until all pushed frames are consumed
+
+        @throw `readback_stream::error` if consumer failed
+    */
+    void flush();
+
+    readback_stats stats() const;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 48, 8> data;
+};
+
+/*
+    consumer, which writes raw pixels of every frame to `fd`, e.g. to pipe of video encoder
+
+    `fd` isn't closed and must stay open while stream is used
+*/
+readback_stream::consumer write_to(int fd);
+
+} // namespace orbi
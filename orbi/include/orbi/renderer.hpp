@@ -0,0 +1,89 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+#include <orbi/timeline.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+namespace orbi
+{
+
+struct device;
+
+/*
+    ring of frames in flight
+
+    every frame owns its own command pool, command buffer and
+    `image_available` semaphore, so cpu can record frame N+1
+    while gpu still executes frame N
+
+    every submission signals the next value of `frame_timeline`,
+    frame waits for value of its previous submission in `begin_frame`
+*/
+struct renderer
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    using frame_index_type = std::uint32_t;
+
+    static constexpr frame_index_type default_frames_in_flight{ 2 };
+
+    /*
+        @pre `dev` must outlive `*this`
+        @pre `frames_in_flight > 0`
+        @throw `renderer::error`
+    */
+    explicit renderer(device const&, frame_index_type frames_in_flight = default_frames_in_flight);
+    // waits until every submitted frame is executed
+    ~renderer();
+
+    renderer(renderer&&) noexcept;
+    renderer& operator=(renderer);
+
+    friend void swap(renderer&, renderer&) noexcept;
+
+    frame_index_type frames_in_flight() const noexcept;
+    frame_index_type current_frame() const noexcept;
+
+    /*
+        `last()` is value of the latest submitted frame, so anything used by it
+        (e.g. resources to destroy) can be released once this value is reached
+    */
+    timeline const& frame_timeline() const noexcept;
+
+    /*
+        the next submission of the current frame waits at `stage` until `t` reaches `value`,
+        e.g. for data uploaded by `uploader`
+
+        @pre `t` outlives the submission
+    */
+    void wait_for(timeline const& t, timeline::value_type value,
+                  vk::PipelineStageFlags2 stage = vk::PipelineStageFlagBits2::eAllCommands);
+
+    /*
+        blocks until gpu finished previous use of the current frame,
+        resets its command pool and collects `device::deletion`
+
+        @throw `renderer::error`
+    */
+    void begin_frame();
+
+    /*
+        moves ring to the next frame
+    */
+    void end_frame() noexcept;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 48, 8> data;
+};
+
+} // namespace orbi
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <span>
+
+namespace orbi
+{
+
+/*
+    layout of image together with stages and accesses, which use it in that layout
+*/
+struct image_state
+{
+    vk::ImageLayout layout{ vk::ImageLayout::eUndefined };
+    vk::PipelineStageFlags2 stage{};
+    vk::AccessFlags2 access{};
+};
+
+namespace image_states
+{
+
+/*
+    swapchain image right after acquire,
+    stage matches stage at which `renderer` waits for acquire semaphore, so transition is ordered after it
+*/
+inline constexpr image_state acquired{ .layout = vk::ImageLayout::eUndefined,
+                                       .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                                       .access = vk::AccessFlagBits2::eNone };
+
+inline constexpr image_state color_attachment{ .layout = vk::ImageLayout::eColorAttachmentOptimal,
+                                               .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                                               .access = vk::AccessFlagBits2::eColorAttachmentWrite };
+
+// presentation is ordered by semaphore, not by barrier
+inline constexpr image_state present{ .layout = vk::ImageLayout::ePresentSrcKHR,
+                                      .stage = vk::PipelineStageFlagBits2::eNone,
+                                      .access = vk::AccessFlagBits2::eNone };
+
+/*
+    image of `offscreen_target` at the beginning of frame, its previous contents are discarded,
+    but transition is still ordered after previous frame rendered to or copied from it
+*/
+inline constexpr image_state discarded{ .layout = vk::ImageLayout::eUndefined,
+                                        .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput |
+                                                 vk::PipelineStageFlagBits2::eCopy,
+                                        .access = vk::AccessFlagBits2::eColorAttachmentWrite };
+
+// e.g. to copy rendered pixels to readback buffer
+inline constexpr image_state transfer_source{ .layout = vk::ImageLayout::eTransferSrcOptimal,
+                                              .stage = vk::PipelineStageFlagBits2::eCopy,
+                                              .access = vk::AccessFlagBits2::eTransferRead };
+
+} // namespace image_states
+
+/*
+    records `vkCmdPipelineBarrier2` with one image barrier, which changes state of whole image
+*/
+void transition(vk::raii::CommandBuffer const&, vk::Image, image_state const& from, image_state const& to,
+                vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor);
+
+struct color_attachment_info
+{
+    vk::ImageView view{};
+    vk::AttachmentLoadOp load_op{ vk::AttachmentLoadOp::eClear };
+    vk::AttachmentStoreOp store_op{ vk::AttachmentStoreOp::eStore };
+    vk::ClearColorValue clear_color{};
+};
+
+/*
+    records `vkCmdBeginRendering`, rendering is ended with `vk::raii::CommandBuffer::endRendering`
+
+    `vk::RenderingFlagBits::eContentsSecondaryCommandBuffers` must be set,
+    if rendering is recorded with `command_recorder::record_rendering`
+
+    @pre attachments are in `image_states::color_attachment`
+*/
+void begin_rendering(vk::raii::CommandBuffer const&, vk::Rect2D area, std::span<color_attachment_info const>,
+                     vk::RenderingFlags flags = {});
+
+} // namespace orbi
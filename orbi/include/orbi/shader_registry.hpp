@@ -0,0 +1,91 @@
+#pragma once
+
+#include <orbi/exception.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace orbi
+{
+
+/*
+    SPIR-V embedded into binary by `orbi_target_shaders` of `cmake/shaders.cmake`,
+    `code` has static storage duration, so `shader_stage_description::storage` is left null for it
+*/
+struct embedded_shader
+{
+    std::string_view name;
+    std::span<std::uint32_t const> code;
+};
+
+struct shader_registry_error : runtime_error
+{
+    using runtime_error::runtime_error;
+};
+
+/*
+    shaders of one generated header, lookup is `constexpr`,
+    so in constant expression misspelled name is reported by compiler
+
+    e.g. `constexpr auto code{ shaders.at("triangle.vert") };`
+*/
+template <std::size_t Count>
+struct shader_registry
+{
+    std::array<embedded_shader, Count> shaders;
+
+    /*
+        @return empty span if there is no shader with `name`
+    */
+    constexpr std::span<std::uint32_t const>
+    find(std::string_view const name) const noexcept
+    {
+        for (auto const& s : shaders)
+        {
+            if (s.name == name)
+            {
+                return s.code;
+            }
+        }
+
+        return {};
+    }
+
+    /*
+        @throw `shader_registry_error` if there is no shader with `name`
+    */
+    constexpr std::span<std::uint32_t const>
+    at(std::string_view const name) const
+    {
+        auto const code{ find(name) };
+        if (code.empty())
+        {
+            throw shader_registry_error{ "shader_registry::at: there is no shader '{}'", name };
+        }
+
+        return code;
+    }
+
+    constexpr auto
+    begin() const noexcept
+    {
+        return shaders.begin();
+    }
+
+    constexpr auto
+    end() const noexcept
+    {
+        return shaders.end();
+    }
+
+    constexpr std::size_t
+    size() const noexcept
+    {
+        return Count;
+    }
+};
+
+} // namespace orbi
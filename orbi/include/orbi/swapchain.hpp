@@ -0,0 +1,86 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <optional>
+
+namespace orbi
+{
+
+struct device;
+struct window;
+struct renderer;
+
+/*
+    swapchain of `window` surface with its images, image views
+    and per image `render_finished` semaphores
+
+    recreation passes old swapchain as `oldSwapchain` and doesn't wait for device idle:
+    old swapchain and its resources are pushed to `device::deletion` and destroyed
+    only after all frames in flight which could use them are finished
+*/
+struct swapchain
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    using image_index_type = std::uint32_t;
+
+    /*
+        @pre `dev` and `win` must outlive `*this`
+        @throw `swapchain::error`
+    */
+    swapchain(device const&, window const&);
+    ~swapchain();
+
+    swapchain(swapchain&&) noexcept;
+    swapchain& operator=(swapchain);
+
+    friend void swap(swapchain&, swapchain&) noexcept;
+
+    /*
+        acquires next image, signaling `image_available` semaphore of current frame of `r`
+
+        recreates swapchain if it is out of date (or was invalidated)
+
+        @pre `r.begin_frame()` was called for current frame
+        @return `std::nullopt` if there is no image to render to in this frame,
+                e.g. swapchain was out of date or window is minimized
+        @throw `swapchain::error`
+    */
+    std::optional<image_index_type> acquire(renderer const& r);
+
+    /*
+        presents image waiting on its `render_finished` semaphore
+
+        @throw `swapchain::error`
+    */
+    void present(image_index_type);
+
+    /*
+        forces recreation on next `acquire`, e.g. after window resize
+    */
+    void invalidate() noexcept;
+
+    /*
+        @return number, which is incremented on each recreation
+
+        can be used to find out that resources depending on swapchain images must be recreated
+    */
+    std::uint64_t generation() const noexcept;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 152, 8> data;
+};
+
+} // namespace orbi
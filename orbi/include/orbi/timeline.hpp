@@ -0,0 +1,122 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+namespace orbi
+{
+
+struct device;
+
+/*
+    timeline semaphore, i.e. monotonically increasing counter signaled by gpu or cpu
+
+    one timeline replaces a fence per submission: each submission signals the next value
+    reserved by `advance`, so "is work done" is just comparison of values,
+    and any queue can wait for value signaled by any other queue
+
+    the greatest reached value seen so far is cached, so polling of already reached values
+    doesn't call driver at all
+
+    all member functions are thread safe
+*/
+struct timeline
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    using value_type = std::uint64_t;
+
+    /*
+        @pre `dev` must outlive `*this`
+        @throw `timeline::error`
+    */
+    explicit timeline(device const&, value_type initial_value = 0);
+
+    /*
+        waits until `last()` is reached, so gpu doesn't use semaphore anymore,
+        then everything waiting for values of `*this` (e.g. `deletion_queue`) may proceed
+
+        @pre every reserved value is signaled eventually, see `advance`
+    */
+    ~timeline();
+
+    timeline(timeline&&) noexcept;
+    timeline& operator=(timeline);
+
+    friend void swap(timeline&, timeline&) noexcept;
+
+    vk::Semaphore semaphore() const noexcept;
+
+    /*
+        reserves value for the next signal, values are strictly increasing
+
+        reserved value must be signaled eventually, otherwise waits for it and all later values never finish
+    */
+    value_type advance() noexcept;
+
+    // the greatest value reserved by `advance` (or initial value)
+    value_type last() const noexcept;
+
+    /*
+        the greatest value known to be reached, doesn't call driver
+    */
+    value_type cached() const noexcept;
+
+    /*
+        queries counter of semaphore and updates cached value
+
+        @throw `timeline::error`
+    */
+    value_type completed() const;
+
+    /*
+        calls driver only if `value` is greater than cached value
+
+        @throw `timeline::error`
+    */
+    bool reached(value_type) const;
+
+    /*
+        blocks until `value` is reached
+
+        @return `false` if `timeout` passed first
+        @throw `timeline::error`
+    */
+    bool wait(value_type, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) const;
+
+    /*
+        signals `value` from cpu, e.g. to release gpu work waiting for cpu
+
+        @pre `value` is greater than current value of counter and isn't signaled by any submission
+        @throw `timeline::error`
+    */
+    void signal(value_type) const;
+
+    /*
+        wait or signal of `value` for `vk::SubmitInfo2`
+
+        waiting submission may be on other queue than signaling one,
+        and it may be submitted before signal (wait-before-signal), e.g. to wait for `signal` from cpu,
+        but signal must eventually be submitted or signaled from cpu, otherwise queue never finishes
+    */
+    vk::SemaphoreSubmitInfo submit_info(value_type, vk::PipelineStageFlags2 = vk::PipelineStageFlagBits2::eAllCommands)
+        const noexcept;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 48, 8> data;
+};
+
+} // namespace orbi
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+
+/*
+    cpu tracing, enabled with `-DORBI_TRACE=ON`
+
+    `ORBI_TRACE_SCOPE("name")` records duration of enclosing scope,
+    without `ORBI_TRACE` it expands to nothing, so disabled tracing costs nothing
+
+    @pre name must be a string literal (or other string with static storage duration)
+*/
+#ifdef ORBI_TRACE
+#    define ORBI_TRACE_CONCAT_IMPL(a, b) a##b
+#    define ORBI_TRACE_CONCAT(a, b) ORBI_TRACE_CONCAT_IMPL(a, b)
+#    define ORBI_TRACE_SCOPE(name)                                                                   \
+        ::orbi::trace::scope const ORBI_TRACE_CONCAT(orbi_trace_scope_, __LINE__)                   \
+        {                                                                                            \
+            name                                                                                     \
+        }
+#else
+#    define ORBI_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+namespace orbi::trace
+{
+
+/*
+    events are kept in per thread ring buffers of this size, older events are overwritten
+*/
+inline constexpr std::size_t ring_capacity{ 16 * 1024 };
+
+/*
+    records complete event at destruction
+
+    prefer `ORBI_TRACE_SCOPE`, which is compiled out when tracing is disabled
+*/
+struct scope
+{
+public:
+    explicit scope(char const* name) noexcept;
+    ~scope();
+
+    scope(scope const&) = delete;
+    scope& operator=(scope const&) = delete;
+
+private:
+    char const* event_name;
+    std::uint64_t begin_ns;
+};
+
+/*
+    writes events of all threads in Chrome trace event format,
+    which is loaded by `chrome://tracing` and Perfetto
+
+    without `ORBI_TRACE` writes valid trace without events
+*/
+void write_chrome_json(std::ostream&);
+
+/*
+    @return `false` if file can't be written
+*/
+bool write_chrome_json(std::filesystem::path const&);
+
+// drops events recorded so far
+void clear() noexcept;
+
+} // namespace orbi::trace
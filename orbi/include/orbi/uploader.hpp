@@ -0,0 +1,146 @@
+#pragma once
+
+#include <orbi/detail/pimpl.hpp>
+#include <orbi/detail/util.hpp>
+#include <orbi/exception.hpp>
+#include <orbi/timeline.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace orbi
+{
+
+struct device;
+struct renderer;
+
+struct upload_stats
+{
+    vk::DeviceSize ring_size{ 0 };
+    // the most bytes of ring used at once
+    vk::DeviceSize peak_ring_usage{ 0 };
+
+    std::uint64_t bytes_uploaded{ 0 };
+    std::uint64_t upload_count{ 0 };
+    // submissions, each one has all uploads since the previous one
+    std::uint64_t batch_count{ 0 };
+    // copy commands recorded, uploads to the same buffer in one batch share one command
+    std::uint64_t copy_command_count{ 0 };
+    // times `upload` blocked until gpu freed space of ring, ring is too small if it grows
+    std::uint64_t stall_count{ 0 };
+};
+
+/*
+    part of image written by `uploader::upload`, data is tightly packed
+*/
+struct image_upload_region
+{
+    // format of image, offset of data in ring must be multiple of its texel block size
+    vk::Format format{ vk::Format::eUndefined };
+    vk::ImageSubresourceLayers subresource{ .aspectMask = vk::ImageAspectFlagBits::eColor, .layerCount = 1 };
+    vk::Offset3D offset{};
+    vk::Extent3D extent{};
+};
+
+/*
+    copies data to gpu through persistently mapped staging ring buffer
+
+    `upload` only copies data into ring and remembers the region, `flush` submits all remembered copies
+    as one batch on transfer queue (the graphics one if there is no dedicated transfer queue),
+    copies to the same buffer are coalesced into one `vkCmdCopyBuffer`
+
+    each batch signals value of `completion()`, space of ring is reused once it is reached,
+    so nothing blocks unless ring is full
+
+    typical frame:
+
+        auto const value{ uploader.upload(buffer, 0, bytes) };
+        uploader.flush();
+        uploader.acquire(renderer, command_buffer); // before commands using uploaded data
+
+    all member functions are thread safe,
+    but if transfer queue is graphics queue itself (graphics family has only one queue and there is
+    no dedicated transfer family) `flush` must not be called concurrently with submissions to graphics queue
+*/
+struct uploader
+{
+public:
+    struct error : runtime_error
+    {
+        using runtime_error::runtime_error;
+    };
+
+    static constexpr vk::DeviceSize default_ring_size{ 64 * 1024 * 1024 };
+
+    /*
+        @pre `dev` must outlive `*this`
+        @pre `ring_size > 0`
+        @throw `uploader::error`
+    */
+    explicit uploader(device const&, vk::DeviceSize ring_size = default_ring_size);
+
+    // waits until all submitted batches are finished, remembered uploads are discarded
+    ~uploader();
+
+    uploader(uploader&&) noexcept;
+    uploader& operator=(uploader);
+
+    friend void swap(uploader&, uploader&) noexcept;
+
+    /*
+        copies `bytes` to `dst` starting with `offset`
+
+        @return value of `completion()`, which is reached once copy is done (after `flush`)
+        @pre `dst` was created with `vk::BufferUsageFlagBits::eTransferDst`
+        @throw `uploader::error` e.g. if `bytes` are larger than ring
+    */
+    timeline::value_type upload(vk::Buffer dst, vk::DeviceSize offset, std::span<std::byte const> bytes);
+
+    /*
+        copies `bytes` to `region` of `dst` and transitions subresource to `final_layout`,
+        content of subresource from before the batch is discarded, so all regions of one subresource
+        must be uploaded before the same `flush`, the last one decides `final_layout`
+
+        @return the same as for buffer
+        @pre `dst` was created with `vk::ImageUsageFlagBits::eTransferDst` and `region.format`
+        @pre `bytes.size()` is size of `region` for `region.format`
+        @throw `uploader::error` e.g. if `bytes` are larger than ring
+    */
+    timeline::value_type upload(vk::Image dst, image_upload_region const& region, std::span<std::byte const> bytes,
+                                vk::ImageLayout final_layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+
+    /*
+        submits uploads since the previous `flush`
+
+        @return value of the submitted batch, or of the previous one if there was nothing to submit
+        @throw `uploader::error`
+    */
+    timeline::value_type flush();
+
+    /*
+        makes all batches submitted so far visible to commands recorded into `command_buffer` after this call:
+        `command_buffer` acquires ownership of resources from dedicated transfer queue (if there is one)
+        and the next submission of the current frame of `r` waits for `completion()`
+
+        the only alternative is to wait for `completion()` on cpu, and only if transfer queue isn't dedicated
+
+        @pre `command_buffer` is the one of the current frame of `r` and is submitted by it
+    */
+    void acquire(renderer& r, vk::raii::CommandBuffer const& command_buffer);
+
+    // signaled by batches
+    timeline const& completion() const noexcept;
+
+    upload_stats stats() const;
+
+    struct impl;
+    friend impl;
+
+private:
+    detail::pimpl<impl, 112, 8> data;
+};
+
+} // namespace orbi
@@ -0,0 +1,189 @@
+#include <orbi/detail/archive.hpp>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <utility>
+
+#ifdef ORBI_ZSTD
+#include <zstd.h>
+#endif
+
+namespace orbi::detail
+{
+
+namespace
+{
+
+// the slowest, but archive is packed once at build time and read many times
+constexpr int zstd_level{ 19 };
+
+struct packed_entry
+{
+    std::string name;
+    std::vector<std::byte> bytes;
+    std::uint64_t size{ 0 };
+    archive_compression compression{ archive_compression::none };
+};
+
+std::vector<std::byte>
+read_file(std::filesystem::path const& path)
+{
+    std::error_code ec;
+    auto const size{ std::filesystem::file_size(path, ec) };
+
+    std::ifstream file{ path, std::ios::binary };
+    if (ec || !file)
+    {
+        throw archive_error{ "write_archive: failed to open '{}'", path.string() };
+    }
+
+    std::vector<std::byte> bytes(size);
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(size)))
+    {
+        throw archive_error{ "write_archive: failed to read '{}'", path.string() };
+    }
+
+    return bytes;
+}
+
+void
+compress(packed_entry& e)
+{
+#ifdef ORBI_ZSTD
+    std::vector<std::byte> compressed(ZSTD_compressBound(e.bytes.size()));
+
+    auto const size{ ZSTD_compress(compressed.data(), compressed.size(), e.bytes.data(), e.bytes.size(), zstd_level) };
+    if (ZSTD_isError(size))
+    {
+        throw archive_error{ "write_archive: failed to compress '{}' with: '{}'", e.name, ZSTD_getErrorName(size) };
+    }
+
+    // incompressible entry is kept as is, so it's still used in place
+    if (size >= e.bytes.size())
+    {
+        return;
+    }
+
+    compressed.resize(size);
+    e.bytes = std::move(compressed);
+    e.compression = archive_compression::zstd;
+#else
+    throw archive_error{ "write_archive: can't compress '{}', orbi is built without ORBI_ZSTD", e.name };
+#endif
+}
+
+constexpr std::uint64_t
+align_up(std::uint64_t const value, std::uint64_t const alignment) noexcept
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+void
+write_archive(std::filesystem::path const& output, std::span<archive_input const> const inputs,
+              bool const compress_entries)
+{
+    std::vector<packed_entry> entries;
+    entries.reserve(inputs.size());
+
+    for (auto const& input : inputs)
+    {
+        packed_entry e{ .name = input.name, .bytes = read_file(input.path) };
+        e.size = e.bytes.size();
+
+        if (compress_entries && !e.bytes.empty())
+        {
+            compress(e);
+        }
+
+        entries.push_back(std::move(e));
+    }
+
+    std::ranges::sort(entries, {}, &packed_entry::name);
+    if (auto const it{ std::ranges::adjacent_find(entries, {}, &packed_entry::name) }; it != end(entries))
+    {
+        throw archive_error{ "write_archive: name '{}' is used by several inputs", it->name };
+    }
+
+    archive_header header{ .magic = archive_magic,
+                           .version = archive_version,
+                           .entry_count = static_cast<std::uint32_t>(entries.size()),
+                           .names_offset = sizeof(archive_header) + entries.size() * sizeof(archive_entry) };
+
+    std::string names;
+    std::vector<archive_entry> index;
+    index.reserve(entries.size());
+
+    for (auto const& e : entries)
+    {
+        if (names.size() + e.name.size() > std::numeric_limits<std::uint32_t>::max())
+        {
+            throw archive_error{ "write_archive: names are too long" };
+        }
+
+        index.push_back({ .stored_size = e.bytes.size(),
+                          .size = e.size,
+                          .name_offset = static_cast<std::uint32_t>(names.size()),
+                          .name_size = static_cast<std::uint32_t>(e.name.size()),
+                          .compression = e.compression });
+        names += e.name;
+    }
+
+    header.names_size = names.size();
+
+    auto offset{ align_up(header.names_offset + header.names_size, archive_alignment) };
+    for (auto& entry : index)
+    {
+        entry.offset = offset;
+        offset = align_up(offset + entry.stored_size, archive_alignment);
+    }
+
+    // unique name, so concurrently running builds don't write the same temporary file
+    auto temporary{ output };
+    temporary += std::format(".{:08x}.tmp", std::random_device{}());
+
+    try
+    {
+        if (auto const parent{ output.parent_path() }; !parent.empty())
+        {
+            std::filesystem::create_directories(parent);
+        }
+
+        std::ofstream file{ temporary, std::ios::binary | std::ios::trunc };
+        file.exceptions(std::ofstream::badbit | std::ofstream::failbit);
+
+        file.write(reinterpret_cast<char const*>(&header), sizeof header);
+        file.write(reinterpret_cast<char const*>(index.data()),
+                   static_cast<std::streamsize>(index.size() * sizeof(archive_entry)));
+        file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+        for (std::size_t i{ 0 }; i < entries.size(); ++i)
+        {
+            // padding up to aligned offset of payload
+            auto const position{ static_cast<std::uint64_t>(file.tellp()) };
+            std::string const padding(index[i].offset - position, '\0');
+            file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+            file.write(reinterpret_cast<char const*>(entries[i].bytes.data()),
+                       static_cast<std::streamsize>(entries[i].bytes.size()));
+        }
+
+        file.close();
+
+        // readers see either old or new archive, never partially written one
+        std::filesystem::rename(temporary, output);
+    }
+    catch (...)
+    {
+        std::error_code ec;
+        std::filesystem::remove(temporary, ec);
+
+        std::throw_with_nested(archive_error{ "write_archive: failed to write '{}'", output.string() });
+    }
+}
+
+} // namespace orbi::detail
@@ -0,0 +1,190 @@
+#include <orbi/asset_archive.hpp>
+#include <orbi/detail/archive.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/trace.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#ifdef ORBI_ZSTD
+#include <zstd.h>
+#endif
+
+namespace orbi
+{
+
+namespace
+{
+
+std::string_view
+name_of(asset_archive::impl const& a, detail::archive_entry const& e) noexcept
+{
+    return a.names.substr(e.name_offset, e.name_size);
+}
+
+detail::archive_entry const*
+find(asset_archive::impl const& a, std::string_view const name) noexcept
+{
+    auto const it{ std::ranges::lower_bound(a.entries, name, {},
+                                            [&](detail::archive_entry const& e) { return name_of(a, e); }) };
+
+    return it != end(a.entries) && name_of(a, *it) == name ? &*it : nullptr;
+}
+
+/*
+    archive comes from disk, so everything is checked once here and trusted later
+
+    @throw `asset_archive::error` if archive is corrupted
+*/
+void
+validate(asset_archive::impl& a, std::filesystem::path const& path)
+{
+    auto const bytes{ a.file.bytes };
+
+    detail::archive_header header;
+    if (bytes.size() < sizeof header)
+    {
+        throw asset_archive::error{ "asset_archive: '{}' is too small", path.string() };
+    }
+
+    std::memcpy(&header, bytes.data(), sizeof header);
+    if (header.magic != detail::archive_magic || header.version != detail::archive_version)
+    {
+        throw asset_archive::error{ "asset_archive: '{}' isn't archive of version {}", path.string(),
+                                    detail::archive_version };
+    }
+
+    auto const index_size{ std::uint64_t{ header.entry_count } * sizeof(detail::archive_entry) };
+    if (header.names_offset != sizeof header + index_size || header.names_offset > bytes.size() ||
+        header.names_size > bytes.size() - header.names_offset)
+    {
+        throw asset_archive::error{ "asset_archive: index of '{}' is out of file", path.string() };
+    }
+
+    // both mapping and heap memory are aligned well enough
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    a.entries = { reinterpret_cast<detail::archive_entry const*>(bytes.data() + sizeof header), header.entry_count };
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    a.names = { reinterpret_cast<char const*>(bytes.data() + header.names_offset), header.names_size };
+
+    for (auto const& e : a.entries)
+    {
+        bool const valid{ std::uint64_t{ e.name_offset } + e.name_size <= header.names_size &&
+                          e.offset <= bytes.size() && e.stored_size <= bytes.size() - e.offset &&
+                          (e.compression != detail::archive_compression::none || e.stored_size == e.size) &&
+                          (e.compression == detail::archive_compression::none ||
+                           e.compression == detail::archive_compression::zstd) };
+        if (!valid)
+        {
+            throw asset_archive::error{ "asset_archive: entry of '{}' is out of file", path.string() };
+        }
+    }
+
+    // binary search relies on it
+    if (!std::ranges::is_sorted(a.entries, {}, [&](detail::archive_entry const& e) { return name_of(a, e); }))
+    {
+        throw asset_archive::error{ "asset_archive: entries of '{}' aren't sorted", path.string() };
+    }
+}
+
+asset
+decompress(asset_archive::impl const& a, detail::archive_entry const& e, std::span<std::byte const> const stored)
+{
+#ifdef ORBI_ZSTD
+    ORBI_TRACE_SCOPE("asset_archive::decompress");
+
+    auto buffer{ std::make_shared<std::vector<std::byte>>(e.size) };
+
+    auto const size{ ZSTD_decompress(buffer->data(), buffer->size(), stored.data(), stored.size()) };
+    if (ZSTD_isError(size) || size != e.size)
+    {
+        throw asset_archive::error{ "asset_archive: failed to decompress '{}'", name_of(a, e) };
+    }
+
+    std::span<std::byte const> const bytes{ *buffer };
+
+    return { .bytes = bytes, .storage = std::move(buffer) };
+#else
+    (void)stored;
+    throw asset_archive::error{ "asset_archive: '{}' is compressed, but orbi is built without ORBI_ZSTD",
+                                name_of(a, e) };
+#endif
+}
+
+} // namespace
+
+asset_archive::asset_archive(asset_source const& source, std::filesystem::path const& path)
+try
+{
+    ORBI_TRACE_SCOPE("asset_archive::asset_archive");
+
+    data->file = source.open(path);
+    validate(*data, path);
+}
+catch (asset_archive::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "asset_archive::asset_archive: failed to open '{}'", path.string() });
+}
+
+asset_archive::~asset_archive() = default;
+
+asset_archive::asset_archive(asset_archive&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+asset_archive&
+asset_archive::operator=(asset_archive other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(asset_archive& l, asset_archive& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+asset
+asset_archive::open(std::string_view const name) const
+{
+    auto const* const e{ find(*data, name) };
+    if (!e)
+    {
+        throw error{ "asset_archive::open: there is no '{}'", name };
+    }
+
+    auto const stored{ data->file.bytes.subspan(e->offset, e->stored_size) };
+    if (e->compression == detail::archive_compression::zstd)
+    {
+        return decompress(*data, *e, stored);
+    }
+
+    // shares mapping of the whole archive
+    return { .bytes = stored, .storage = data->file.storage };
+}
+
+bool
+asset_archive::contains(std::string_view const name) const noexcept
+{
+    return find(*data, name) != nullptr;
+}
+
+std::uint32_t
+asset_archive::size() const noexcept
+{
+    return static_cast<std::uint32_t>(data->entries.size());
+}
+
+} // namespace orbi
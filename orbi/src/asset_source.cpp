@@ -0,0 +1,238 @@
+#include <orbi/asset_source.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/detail/thread_pool.hpp>
+#include <orbi/trace.hpp>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace orbi
+{
+
+namespace
+{
+
+/*
+    @return `std::nullopt` if file exists, but can't be mapped
+    @throw `asset_source::error` if file can't be opened
+*/
+std::optional<asset>
+map(std::filesystem::path const& path)
+{
+#ifdef _WIN32
+    auto const file{ ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                   FILE_ATTRIBUTE_NORMAL, nullptr) };
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw asset_source::error{ "asset_source: failed to open '{}' with error {}", path.string(),
+                                   ::GetLastError() };
+    }
+
+    LARGE_INTEGER size{};
+    if (!::GetFileSizeEx(file, &size) || ::GetFileType(file) != FILE_TYPE_DISK)
+    {
+        ::CloseHandle(file);
+        return std::nullopt;
+    }
+
+    // empty file can't be mapped, but it's a valid asset
+    if (size.QuadPart == 0)
+    {
+        ::CloseHandle(file);
+        return asset{};
+    }
+
+    // view keeps mapping alive, and mapping keeps file alive
+    auto const mapping{ ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) };
+    ::CloseHandle(file);
+    if (!mapping)
+    {
+        return std::nullopt;
+    }
+
+    auto* const view{ ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) };
+    ::CloseHandle(mapping);
+    if (!view)
+    {
+        return std::nullopt;
+    }
+
+    std::shared_ptr<void> storage{ view, [](void* const p) { ::UnmapViewOfFile(p); } };
+    auto const byte_count{ static_cast<std::size_t>(size.QuadPart) };
+#else
+    auto const fd{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+    if (fd < 0)
+    {
+        throw asset_source::error{ "asset_source: failed to open '{}' with: '{}'", path.string(),
+                                   std::strerror(errno) };
+    }
+
+    struct stat status{};
+    if (::fstat(fd, &status) != 0 || !S_ISREG(status.st_mode))
+    {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    // empty file can't be mapped, but it's a valid asset
+    auto const byte_count{ static_cast<std::size_t>(status.st_size) };
+    if (byte_count == 0)
+    {
+        ::close(fd);
+        return asset{};
+    }
+
+    // mapping keeps file alive
+    auto* const view{ ::mmap(nullptr, byte_count, PROT_READ, MAP_PRIVATE, fd, 0) };
+    ::close(fd);
+    if (view == MAP_FAILED)
+    {
+        return std::nullopt;
+    }
+
+    std::shared_ptr<void> storage{ view, [byte_count](void* const p) { ::munmap(p, byte_count); } };
+#endif
+
+    return asset{ .bytes = { static_cast<std::byte const*>(view), byte_count }, .storage = std::move(storage) };
+}
+
+/*
+    @throw `asset_source::error` if file can't be opened or read
+*/
+asset
+read_whole(std::filesystem::path const& path)
+{
+    ORBI_TRACE_SCOPE("asset_source::read");
+
+    std::ifstream file{ path, std::ios::binary };
+    if (!file)
+    {
+        throw asset_source::error{ "asset_source: failed to open '{}'", path.string() };
+    }
+
+    auto buffer{ std::make_shared<std::vector<std::byte>>() };
+
+    // size of e.g. pipe isn't known in advance
+    std::error_code ec;
+    if (auto const size{ std::filesystem::file_size(path, ec) }; !ec)
+    {
+        buffer->reserve(size);
+    }
+
+    std::array<char, 64 * 1024> chunk{};
+    while (file)
+    {
+        file.read(chunk.data(), chunk.size());
+
+        auto const* const first{ reinterpret_cast<std::byte const*>(chunk.data()) };
+        buffer->insert(end(*buffer), first, first + file.gcount());
+    }
+
+    if (file.bad())
+    {
+        throw asset_source::error{ "asset_source: failed to read '{}'", path.string() };
+    }
+
+    std::span<std::byte const> const bytes{ *buffer };
+
+    return { .bytes = bytes, .storage = std::move(buffer) };
+}
+
+} // namespace
+
+asset_source::asset_source(std::filesystem::path root, std::uint32_t const thread_count)
+try
+{
+    data->root = std::move(root);
+    data->pool = std::make_unique<detail::thread_pool>(thread_count);
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "asset_source::asset_source: failed to start worker threads" });
+}
+
+asset_source::~asset_source() = default;
+
+asset_source::asset_source(asset_source&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+asset_source&
+asset_source::operator=(asset_source other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(asset_source& l, asset_source& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+asset
+asset_source::open(std::filesystem::path const& path) const
+{
+    ORBI_TRACE_SCOPE("asset_source::open");
+
+    auto const full_path{ data->root / path };
+
+    if (auto mapped{ map(full_path) })
+    {
+        return *std::move(mapped);
+    }
+
+    return read_whole(full_path);
+}
+
+std::future<asset>
+asset_source::read(std::filesystem::path const& path) const
+{
+    // `std::function` of task must be copyable
+    auto promise{ std::make_shared<std::promise<asset>>() };
+    auto future{ promise->get_future() };
+
+    data->pool->submit(
+        [promise, full_path = data->root / path]
+        {
+            try
+            {
+                promise->set_value(read_whole(full_path));
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            }
+        });
+
+    return future;
+}
+
+std::filesystem::path const&
+asset_source::root() const noexcept
+{
+    return data->root;
+}
+
+} // namespace orbi
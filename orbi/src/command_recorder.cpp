@@ -0,0 +1,236 @@
+#include <orbi/command_recorder.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/renderer.hpp>
+#include <orbi/trace.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <latch>
+#include <utility>
+
+namespace orbi
+{
+
+namespace
+{
+
+/*
+    command buffer, which isn't used by current frame yet,
+    command buffers of pool without `eResetCommandBuffer` can't be begun again until pool is reset
+
+    @pre no other thread uses slot
+*/
+vk::raii::CommandBuffer const&
+next_command_buffer(command_recorder::impl& r, std::uint32_t const thread)
+{
+    auto const frame{ r.current_frame };
+    auto& slot{ r.at(frame, thread) };
+
+    if (slot.used == slot.command_buffers.size())
+    {
+        slot.command_buffers.push_back(std::move(r.dev->vk_device
+                                                     .allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+                                                         .commandPool = slot.command_pool,
+                                                         .level = vk::CommandBufferLevel::eSecondary,
+                                                         .commandBufferCount = 1 })
+                                                     .front()));
+
+        r.dev->set_name(*slot.command_buffers.back(), "orbi::command_recorder frame {} thread {} buffer {}", frame,
+                        thread, slot.used);
+    }
+
+    return slot.command_buffers[slot.used++];
+}
+
+void
+record_parallel(command_recorder::impl& r, vk::raii::CommandBuffer const& primary, std::uint32_t const count,
+                vk::CommandBufferBeginInfo const& begin_info, command_recorder::record_function const& fn)
+{
+    ORBI_TRACE_SCOPE("command_recorder::record");
+
+    auto const threads{ std::min(r.thread_count, count) };
+    if (threads == 0)
+    {
+        return;
+    }
+
+    // the previous `record` of frame still uses its command buffers, so each call takes new ones
+    std::vector<vk::raii::CommandBuffer const*> command_buffers;
+    command_buffers.reserve(threads);
+    for (std::uint32_t t{ 0 }; t < threads; ++t)
+    {
+        command_buffers.push_back(&next_command_buffer(r, t));
+    }
+
+    std::vector<std::exception_ptr> errors(threads);
+    std::latch workers_done{ threads - 1 };
+
+    auto const record_range = [&](std::uint32_t const t) noexcept
+    {
+        ORBI_TRACE_SCOPE("command_recorder::record_range");
+
+        try
+        {
+            auto const first{ static_cast<std::uint32_t>(std::uint64_t{ count } * t / threads) };
+            auto const last{ static_cast<std::uint32_t>(std::uint64_t{ count } * (t + 1) / threads) };
+            auto const& command_buffer{ *command_buffers[t] };
+
+            command_buffer.begin(begin_info);
+            r.dev->begin_label(command_buffer, "orbi::command_recorder::record");
+            fn(command_buffer, first, last);
+            r.dev->end_label(command_buffer);
+            command_buffer.end();
+        }
+        catch (...)
+        {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    for (std::uint32_t t{ 1 }; t < threads; ++t)
+    {
+        r.pool->submit(
+            [&, t]
+            {
+                record_range(t);
+                workers_done.count_down();
+            });
+    }
+
+    record_range(0);
+    workers_done.wait();
+
+    for (auto const& e : errors)
+    {
+        if (e)
+        {
+            std::rethrow_exception(e);
+        }
+    }
+
+    std::vector<vk::CommandBuffer> secondaries;
+    secondaries.reserve(threads);
+    for (auto const* const command_buffer : command_buffers)
+    {
+        secondaries.push_back(*command_buffer);
+    }
+
+    primary.executeCommands(secondaries);
+}
+
+} // namespace
+
+command_recorder::command_recorder(device const& dev, frame_index_type const frames_in_flight,
+                                   std::uint32_t const worker_count)
+try
+{
+    assert(frames_in_flight > 0);
+
+    auto const& dev_impl{ device::impl::from_device(dev) };
+    auto const& vk_device{ dev_impl.vk_device };
+
+    data->dev = &dev_impl;
+    data->pool = std::make_unique<detail::thread_pool>(worker_count);
+    data->thread_count = data->pool->thread_count() + 1;
+    data->slots.reserve(std::size_t{ frames_in_flight } * data->thread_count);
+
+    for (std::size_t i{ 0 }; i < std::size_t{ frames_in_flight } * data->thread_count; ++i)
+    {
+        impl::slot slot;
+
+        slot.command_pool = vk::raii::CommandPool{
+            vk_device, vk::CommandPoolCreateInfo{ .flags = vk::CommandPoolCreateFlagBits::eTransient,
+                                                  .queueFamilyIndex = dev_impl.graphics_queue.family_index }
+        };
+
+        data->slots.push_back(std::move(slot));
+    }
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "command_recorder::command_recorder: Internal call to vulkan failed" });
+}
+
+command_recorder::~command_recorder() = default;
+
+command_recorder::command_recorder(command_recorder&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+command_recorder&
+command_recorder::operator=(command_recorder other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(command_recorder& l, command_recorder& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+void
+command_recorder::begin_frame(renderer const& r)
+try
+{
+    data->current_frame = r.current_frame();
+
+    for (std::uint32_t t{ 0 }; t < data->thread_count; ++t)
+    {
+        auto& slot{ data->at(data->current_frame, t) };
+        slot.command_pool.reset();
+        slot.used = 0;
+    }
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "command_recorder::begin_frame: Internal call to vulkan failed" });
+}
+
+void
+command_recorder::record(vk::raii::CommandBuffer const& primary, std::uint32_t const count,
+                         record_function const& fn)
+{
+    vk::CommandBufferInheritanceInfo const inheritance{};
+
+    record_parallel(*data, primary, count,
+                    { .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit, .pInheritanceInfo = &inheritance },
+                    fn);
+}
+
+void
+command_recorder::record_rendering(vk::raii::CommandBuffer const& primary, rendering_inheritance const& rendering,
+                                   std::uint32_t const count, record_function const& fn)
+{
+    vk::CommandBufferInheritanceRenderingInfo const rendering_info{
+        .colorAttachmentCount = static_cast<std::uint32_t>(rendering.color_formats.size()),
+        .pColorAttachmentFormats = rendering.color_formats.data(),
+        .depthAttachmentFormat = rendering.depth_format,
+        .rasterizationSamples = vk::SampleCountFlagBits::e1
+    };
+
+    vk::CommandBufferInheritanceInfo const inheritance{ .pNext = &rendering_info };
+
+    record_parallel(*data, primary, count,
+                    { .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit |
+                               vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+                      .pInheritanceInfo = &inheritance },
+                    fn);
+}
+
+std::uint32_t
+command_recorder::thread_count() const noexcept
+{
+    return data->thread_count;
+}
+
+} // namespace orbi
@@ -1,36 +1,37 @@
 #include <orbi/context.hpp>
+#include <orbi/detail/debug_log.hpp>
 #include <orbi/detail/impl.hpp>
 #include <orbi/detail/util.hpp>
+#include <orbi/trace.hpp>
 
 #include <SDL3/SDL_init.h>
 #include <SDL3/SDL_vulkan.h>
 
 #include <vulkan/vulkan_raii.hpp>
 
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string_view>
 #include <utility>
 
 namespace orbi
 {
 
-namespace
+context::context(app_info const& app_info, context_options const& options)
+try
 {
+    ORBI_TRACE_SCOPE("context::context");
 
-VKAPI_ATTR VkBool32 VKAPI_CALL vk_debug_callback(VkDebugUtilsMessageSeverityFlagBitsEXT, unsigned int,
-                                                 VkDebugUtilsMessengerCallbackDataEXT const*, void*);
-
-}
+    data->headless = options.headless;
 
-context::context(app_info const& app_info)
-try
-{
-    if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS))
+    // headless context loads vulkan with `vk::raii::Context` alone and needs no SDL at all
+    if (!options.headless && !SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS))
     {
         throw error{ "SDL_Init failed with: '{}'", SDL_GetError() };
     }
 
-    if (!SDL_Vulkan_LoadLibrary(nullptr))
+    if (!options.headless && !SDL_Vulkan_LoadLibrary(nullptr))
     {
         throw error{ "SDL_Vulkan_LoadLibrary failed with: '{}'", SDL_GetError() };
     }
@@ -46,30 +47,71 @@ try
 
     vk::InstanceCreateInfo instance_create_info{ .pApplicationInfo = &vulkan_app_info };
 
-    auto const* const needed_extensions =
-        SDL_Vulkan_GetInstanceExtensions(&instance_create_info.enabledExtensionCount);
-    if (!needed_extensions)
+    std::vector<char const*> extensions;
+    if (!options.headless)
     {
-        throw error{ "SDL_Vulkan_GetInstanceExtensions failed with: '{}'", SDL_GetError() };
+        auto const* const needed_extensions =
+            SDL_Vulkan_GetInstanceExtensions(&instance_create_info.enabledExtensionCount);
+        if (!needed_extensions)
+        {
+            throw error{ "SDL_Vulkan_GetInstanceExtensions failed with: '{}'", SDL_GetError() };
+        }
+
+        extensions.assign(needed_extensions,
+                          // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                          needed_extensions + instance_create_info.enabledExtensionCount);
     }
 
-    std::vector<char const*> extensions{ needed_extensions,
-                                         // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-                                         needed_extensions + instance_create_info.enabledExtensionCount };
+    auto const level{ options.instrumentation_level };
+    data->instrumentation_level = level;
 
-    extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
-    instance_create_info.enabledExtensionCount = extensions.size();
-    instance_create_info.ppEnabledExtensionNames = extensions.data();
+    if (level >= instrumentation::markers)
+    {
+        extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    }
 
-#ifndef NDEBUG
     std::array const layers{ "VK_LAYER_KHRONOS_validation" };
+    if (level >= instrumentation::validation)
+    {
+        auto const available{ data->vulkan_context.enumerateInstanceLayerProperties() };
+        auto const is_validation = [&](vk::LayerProperties const& l)
+        { return std::string_view{ l.layerName } == layers[0]; };
+        if (std::ranges::none_of(available, is_validation))
+        {
+            throw error{ "context::context: '{}' is requested, but isn't available", layers[0] };
+        }
 
-    instance_create_info.enabledLayerCount = layers.size();
-    instance_create_info.ppEnabledLayerNames = layers.data();
-#endif
+        instance_create_info.enabledLayerCount = layers.size();
+        instance_create_info.ppEnabledLayerNames = layers.data();
+    }
+
+    std::array const gpu_assisted_features{ vk::ValidationFeatureEnableEXT::eGpuAssisted,
+                                            vk::ValidationFeatureEnableEXT::eGpuAssistedReserveBindingSlot };
+    vk::ValidationFeaturesEXT const validation_features{
+        .enabledValidationFeatureCount = gpu_assisted_features.size(),
+        .pEnabledValidationFeatures = gpu_assisted_features.data()
+    };
+
+    if (level >= instrumentation::gpu_assisted)
+    {
+        // provided by validation layer itself
+        extensions.push_back(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME);
+        instance_create_info.pNext = &validation_features;
+    }
+
+    instance_create_info.enabledExtensionCount = extensions.size();
+    instance_create_info.ppEnabledExtensionNames = extensions.data();
 
     data->vulkan_instance = vk::raii::Instance{ data->vulkan_context, instance_create_info };
 
+    // without validation layer there is (almost) nobody to send messages, so no thread is started for them
+    if (level < instrumentation::validation)
+    {
+        return;
+    }
+
+    data->log = std::make_unique<detail::debug_log>(options.debug_sinks);
+
     data->debug_utils_messenger = [&]() -> vk::raii::DebugUtilsMessengerEXT
     {
         auto const severity_flags(vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning |
@@ -82,7 +124,8 @@ try
         return { data->vulkan_instance,
                  vk::DebugUtilsMessengerCreateInfoEXT{ .messageSeverity = severity_flags,
                                                        .messageType = type_flags,
-                                                       .pfnUserCallback = &vk_debug_callback } };
+                                                       .pfnUserCallback = &detail::debug_log::callback,
+                                                       .pUserData = data->log.get() } };
     }();
 }
 catch (context::error const&)
@@ -96,7 +139,7 @@ catch (...)
 
 context::~context()
 {
-    if (need_release_resource)
+    if (need_release_resource && !data->headless)
     {
         SDL_Quit();
         SDL_Vulkan_UnloadLibrary();
@@ -123,75 +166,19 @@ swap(context& l, context& r) noexcept
     using std::swap;
 
     swap(l.need_release_resource, r.need_release_resource);
+    swap(*l.data, *r.data);
 }
 
-namespace
+bool
+context::headless() const noexcept
 {
+    return data->headless;
+}
 
-VKAPI_ATTR VkBool32 VKAPI_CALL
-vk_debug_callback(VkDebugUtilsMessageSeverityFlagBitsEXT severity, unsigned int type,
-                  VkDebugUtilsMessengerCallbackDataEXT const* data, void* /*user_data*/)
+instrumentation
+context::instrumentation_level() const noexcept
 {
-    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-    std::ostringstream message;
-
-    // clang-format off
-        message << std::format("{}: {}:\n"
-                               "\tmessageIdName = <{}>\n"
-                               "\tmessageIdNumber = <{:#x}>\n"
-                               "\tmessage = <{}>\n",
-                               vk::to_string(static_cast<vk::DebugUtilsMessageSeverityFlagBitsEXT>(severity)),
-                               vk::to_string(static_cast<vk::DebugUtilsMessageTypeFlagsEXT>(type)),
-                               data->pMessageIdName,
-                               data->messageIdNumber,
-                               data->pMessage);
-    // clang-format on
-
-    if (data->queueLabelCount > 0)
-    {
-        message << "\tQueue Labels:\n";
-        for (uint32_t i{ 0 }; i < data->queueLabelCount; i++)
-        {
-            message << std::format("\t\tlabelName = <{}>\n", data->pQueueLabels[i].pLabelName);
-        }
-    }
-
-    if (data->cmdBufLabelCount > 0)
-    {
-        message << "\tCommandBuffer Labels:\n";
-        for (uint32_t i = 0; i < data->cmdBufLabelCount; i++)
-        {
-            message << std::format("\t\tlabelName = <{}>\n", data->pCmdBufLabels[i].pLabelName);
-        }
-    }
-
-    if (data->objectCount > 0)
-    {
-        message << std::format("\tObjects:\n");
-        for (uint32_t i{ 0 }; i < data->objectCount; i++)
-        {
-            // clang-format off
-                message << std::format("\t\tObject {}\n"
-                                       "\t\t\tobjectType = {}\n"
-                                       "\t\t\tobjectHandle = {:#x}\n",
-                                       i,
-                                       vk::to_string(static_cast<vk::ObjectType>(data->pObjects[i].objectType)),
-                                       data->pObjects[i].objectHandle);
-
-                if (data->pObjects[i].pObjectName)
-                {
-                    message << std::format("\t\t\tobjectName = <{}>\n", data->pObjects[i].pObjectName);
-                }
-            // clang-format on
-        }
-    }
-
-    std::cout << message.str() << std::endl;
-
-    return false;
-    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return data->instrumentation_level;
 }
 
-} // namespace
-
 } // namespace orbi
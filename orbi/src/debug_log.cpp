@@ -0,0 +1,396 @@
+#include <orbi/debug_log.hpp>
+#include <orbi/detail/debug_log.hpp>
+#include <orbi/exception.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+namespace orbi
+{
+
+debug_sink
+stderr_sink()
+{
+    return [](debug_message const& m) { std::cerr << m.text << '\n'; };
+}
+
+debug_sink
+file_sink(std::filesystem::path const& path)
+{
+    auto file{ std::make_shared<std::ofstream>(path, std::ios::app) };
+    if (!*file)
+    {
+        throw runtime_error{ "file_sink: failed to open '{}'", path.string() };
+    }
+
+    return [file = std::move(file)](debug_message const& m) { *file << m.text << std::endl; };
+}
+
+namespace detail
+{
+
+debug_log::debug_log(std::vector<debug_sink> s)
+    : sinks{ std::move(s) }
+    , queue{ std::make_unique<mpsc_queue<entry, queue_capacity>>() }
+    , dedup{ std::make_unique<std::array<dedup_slot, dedup_capacity>>() }
+{
+    if (sinks.empty())
+    {
+        sinks.push_back(stderr_sink());
+    }
+
+    thread = std::thread{ [this] { run(); } };
+}
+
+debug_log::~debug_log()
+{
+    {
+        std::scoped_lock const lock{ mutex };
+        stopping = true;
+    }
+
+    wake_up.notify_one();
+    thread.join();
+}
+
+bool
+debug_log::push(vk::DebugUtilsMessageSeverityFlagBitsEXT const severity, vk::DebugUtilsMessageTypeFlagsEXT const type,
+                vk::DebugUtilsMessengerCallbackDataEXT const& data) noexcept
+{
+    // without free slot in table id is just not deduplicated
+    auto* const slot{ data.messageIdNumber != 0 ? slot_of(data.messageIdNumber) : nullptr };
+    if (slot)
+    {
+        slot->count.fetch_add(1, std::memory_order_relaxed);
+
+        if (slot->queued.exchange(true, std::memory_order_acq_rel))
+        {
+            return false;
+        }
+    }
+
+    if (queue->try_push([&](entry& e) noexcept { fill(e, severity, type, data); }))
+    {
+        // notification without mutex may be lost, then message is delivered by the next summary at the latest
+        pushed.store(true, std::memory_order_release);
+        wake_up.notify_one();
+
+        return true;
+    }
+
+    // only own increment is rolled back, duplicates counted meanwhile are still reported,
+    // and the next message with this id is queued instead
+    if (slot)
+    {
+        slot->count.fetch_sub(1, std::memory_order_relaxed);
+        slot->queued.store(false, std::memory_order_release);
+    }
+
+    dropped.fetch_add(1, std::memory_order_relaxed);
+
+    return false;
+}
+
+VKAPI_ATTR VkBool32 VKAPI_CALL
+debug_log::callback(VkDebugUtilsMessageSeverityFlagBitsEXT const severity, VkDebugUtilsMessageTypeFlagsEXT const type,
+                    VkDebugUtilsMessengerCallbackDataEXT const* const data, void* const user_data)
+{
+    static_cast<debug_log*>(user_data)->push(static_cast<vk::DebugUtilsMessageSeverityFlagBitsEXT>(severity),
+                                             static_cast<vk::DebugUtilsMessageTypeFlagsEXT>(type),
+                                             *reinterpret_cast<vk::DebugUtilsMessengerCallbackDataEXT const*>(data));
+
+    return VK_FALSE;
+}
+
+debug_log::text_range
+debug_log::append(entry& e, char const* const text) noexcept
+{
+    if (!text)
+    {
+        return {};
+    }
+
+    auto const size{ std::min(std::strlen(text), max_chars - e.chars_used) };
+    std::memcpy(e.chars.data() + e.chars_used, text, size);
+
+    text_range const r{ .offset = e.chars_used, .size = static_cast<std::uint16_t>(size) };
+    e.chars_used = static_cast<std::uint16_t>(e.chars_used + size);
+
+    return r;
+}
+
+void
+debug_log::fill(entry& e, vk::DebugUtilsMessageSeverityFlagBitsEXT const severity,
+                vk::DebugUtilsMessageTypeFlagsEXT const type,
+                vk::DebugUtilsMessengerCallbackDataEXT const& data) noexcept
+{
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    e.severity = severity;
+    e.type = type;
+    e.id = data.messageIdNumber;
+    e.chars_used = 0;
+
+    // the most useful parts go first, so only tail of long message is truncated
+    e.id_name = append(e, data.pMessageIdName);
+    e.message = append(e, data.pMessage);
+
+    e.object_count = std::min<std::uint32_t>(data.objectCount, max_objects);
+    for (std::uint32_t i{ 0 }; i < e.object_count; ++i)
+    {
+        e.objects[i] = { .type = data.pObjects[i].objectType,
+                         .handle = data.pObjects[i].objectHandle,
+                         .name = append(e, data.pObjects[i].pObjectName) };
+    }
+
+    e.queue_label_count = std::min<std::uint32_t>(data.queueLabelCount, max_labels);
+    for (std::uint32_t i{ 0 }; i < e.queue_label_count; ++i)
+    {
+        e.queue_labels[i] = append(e, data.pQueueLabels[i].pLabelName);
+    }
+
+    e.command_buffer_label_count = std::min<std::uint32_t>(data.cmdBufLabelCount, max_labels);
+    for (std::uint32_t i{ 0 }; i < e.command_buffer_label_count; ++i)
+    {
+        e.command_buffer_labels[i] = append(e, data.pCmdBufLabels[i].pLabelName);
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+std::string
+debug_log::format(entry const& e)
+{
+    auto const view = [&](text_range const r) { return std::string_view{ e.chars.data() + r.offset, r.size }; };
+
+    // clang-format off
+    auto message{ std::format("{}: {}:\n"
+                              "\tmessageIdName = <{}>\n"
+                              "\tmessageIdNumber = <{:#x}>\n"
+                              "\tmessage = <{}>\n",
+                              vk::to_string(e.severity),
+                              vk::to_string(e.type),
+                              view(e.id_name),
+                              static_cast<std::uint32_t>(e.id),
+                              view(e.message)) };
+    // clang-format on
+
+    if (e.queue_label_count > 0)
+    {
+        message += "\tQueue Labels:\n";
+        for (std::uint32_t i{ 0 }; i < e.queue_label_count; ++i)
+        {
+            message += std::format("\t\tlabelName = <{}>\n", view(e.queue_labels[i]));
+        }
+    }
+
+    if (e.command_buffer_label_count > 0)
+    {
+        message += "\tCommandBuffer Labels:\n";
+        for (std::uint32_t i{ 0 }; i < e.command_buffer_label_count; ++i)
+        {
+            message += std::format("\t\tlabelName = <{}>\n", view(e.command_buffer_labels[i]));
+        }
+    }
+
+    if (e.object_count > 0)
+    {
+        message += "\tObjects:\n";
+        for (std::uint32_t i{ 0 }; i < e.object_count; ++i)
+        {
+            auto const& o{ e.objects[i] };
+
+            // clang-format off
+            message += std::format("\t\tObject {}\n"
+                                   "\t\t\tobjectType = {}\n"
+                                   "\t\t\tobjectHandle = {:#x}\n",
+                                   i,
+                                   vk::to_string(o.type),
+                                   o.handle);
+            // clang-format on
+
+            if (o.name.size > 0)
+            {
+                message += std::format("\t\t\tobjectName = <{}>\n", view(o.name));
+            }
+        }
+    }
+
+    return message;
+}
+
+debug_log::dedup_slot*
+debug_log::slot_of(std::int32_t const id) noexcept
+{
+    // Fibonacci hashing, high bits of product are well mixed even for similar ids
+    auto const hash{ static_cast<std::uint32_t>(static_cast<std::uint32_t>(id) * 2654435769u) };
+    auto const start{ (std::uint64_t{ hash } * dedup_capacity) >> 32 };
+
+    for (std::size_t i{ 0 }; i < dedup_capacity; ++i)
+    {
+        auto& slot{ (*dedup)[(start + i) % dedup_capacity] };
+
+        auto expected{ slot.id.load(std::memory_order_acquire) };
+        if (expected == 0 && slot.id.compare_exchange_strong(expected, id, std::memory_order_acq_rel))
+        {
+            return &slot;
+        }
+
+        // `expected` is id, which took the slot, including other thread with the same `id`
+        if (expected == id)
+        {
+            return &slot;
+        }
+    }
+
+    return nullptr;
+}
+
+void
+debug_log::run()
+{
+    auto next_summary{ std::chrono::steady_clock::now() + summary_interval };
+
+    while (true)
+    {
+        bool stop{ false };
+        {
+            std::unique_lock lock{ mutex };
+            wake_up.wait_until(lock, next_summary,
+                               [this] { return stopping || pushed.exchange(false, std::memory_order_acquire); });
+            stop = stopping;
+        }
+
+        drain();
+
+        if (stop || std::chrono::steady_clock::now() >= next_summary)
+        {
+            report_repeats();
+            report_dropped();
+            next_summary = std::chrono::steady_clock::now() + summary_interval;
+        }
+
+        if (stop)
+        {
+            return;
+        }
+    }
+}
+
+void
+debug_log::drain()
+{
+    while (queue->try_pop(
+        [this](entry const& e)
+        {
+            try
+            {
+                if (e.id != 0)
+                {
+                    auto const [it, inserted] = seen_ids.try_emplace(e.id);
+                    if (inserted)
+                    {
+                        it->second = { .severity = e.severity,
+                                       .type = e.type,
+                                       .id_name = std::string{ e.chars.data() + e.id_name.offset, e.id_name.size } };
+                    }
+                }
+
+                auto const text{ format(e) };
+                deliver({ .severity = e.severity, .type = e.type, .id = e.id, .text = text, .repeats = 0 });
+            }
+            catch (...)
+            {
+                // out of memory, message is lost
+            }
+        }))
+    {
+    }
+}
+
+void
+debug_log::report_repeats()
+{
+    for (auto const& slot : *dedup)
+    {
+        auto const id{ slot.id.load(std::memory_order_acquire) };
+
+        // first message of `id` may be still in queue, then its repeats are reported by next summary
+        auto const it{ id != 0 ? seen_ids.find(id) : end(seen_ids) };
+        if (it == end(seen_ids))
+        {
+            continue;
+        }
+
+        auto& s{ it->second };
+        auto const count{ slot.count.load(std::memory_order_relaxed) };
+        if (count <= s.reported)
+        {
+            continue;
+        }
+
+        auto const repeats{ count - s.reported };
+        s.reported = count;
+
+        try
+        {
+            auto const text{ std::format("{}: {}: messageIdName = <{}> (messageIdNumber = <{:#x}>) repeated {} times",
+                                         vk::to_string(s.severity), vk::to_string(s.type), s.id_name,
+                                         static_cast<std::uint32_t>(id), repeats) };
+
+            deliver({ .severity = s.severity, .type = s.type, .id = id, .text = text, .repeats = repeats });
+        }
+        catch (...)
+        {
+            // out of memory, summary is lost
+        }
+    }
+}
+
+void
+debug_log::report_dropped()
+{
+    auto const count{ dropped.exchange(0, std::memory_order_relaxed) };
+    if (count == 0)
+    {
+        return;
+    }
+
+    try
+    {
+        auto const text{ std::format("debug_log: {} messages were dropped, because queue was full", count) };
+
+        deliver({ .severity = vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning,
+                  .type = vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral,
+                  .text = text });
+    }
+    catch (...)
+    {
+        // out of memory, count is lost
+    }
+}
+
+void
+debug_log::deliver(debug_message const& m) const noexcept
+{
+    for (auto const& sink : sinks)
+    {
+        try
+        {
+            sink(m);
+        }
+        catch (...)
+        {
+            // sink can't report its own failure anywhere
+        }
+    }
+}
+
+} // namespace detail
+
+} // namespace orbi
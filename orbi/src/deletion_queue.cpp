@@ -0,0 +1,149 @@
+#include <orbi/deletion_queue.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/timeline.hpp>
+#include <orbi/trace.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace orbi
+{
+
+deletion_queue::deletion_queue()
+{
+    data->shared = std::make_unique<impl::state>();
+}
+
+deletion_queue::~deletion_queue() = default;
+
+deletion_queue::deletion_queue(deletion_queue&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+deletion_queue&
+deletion_queue::operator=(deletion_queue other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(deletion_queue& l, deletion_queue& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+void
+deletion_queue::push_erased(timeline const& t, timeline::value_type const value, std::shared_ptr<void> resource)
+{
+    impl::push(*this, timeline::impl::from_timeline(t).shared, value, std::move(resource));
+}
+
+std::size_t
+deletion_queue::collect()
+try
+{
+    ORBI_TRACE_SCOPE("deletion_queue::collect");
+
+    auto& shared{ *data->shared };
+
+    // destroyed outside of lock, destructor of resource may push to the queue too
+    std::vector<impl::entry> finished;
+    {
+        std::scoped_lock const lock{ shared.mutex };
+
+        // cached values are always checked, but driver is queried only once per timeline
+        std::vector<timeline::impl::shared_state const*> polled;
+        auto const reached = [&](impl::entry const& e)
+        {
+            auto& t{ *e.source };
+            if (t.completed.load(std::memory_order_relaxed) >= e.value)
+            {
+                return true;
+            }
+
+            if (std::ranges::find(polled, &t) != end(polled))
+            {
+                return false;
+            }
+
+            polled.push_back(&t);
+
+            return timeline::impl::poll(t) >= e.value;
+        };
+
+        auto const first_pending{ std::ranges::stable_partition(shared.entries, reached).begin() };
+        finished.assign(std::make_move_iterator(begin(shared.entries)), std::make_move_iterator(first_pending));
+        shared.entries.erase(begin(shared.entries), first_pending);
+    }
+
+    return finished.size();
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "deletion_queue::collect: Internal call to vulkan failed" });
+}
+
+void
+deletion_queue::flush()
+try
+{
+    ORBI_TRACE_SCOPE("deletion_queue::flush");
+
+    auto& shared{ *data->shared };
+
+    std::vector<impl::entry> all;
+    {
+        std::scoped_lock const lock{ shared.mutex };
+        all.swap(shared.entries);
+    }
+
+    for (auto const& e : all)
+    {
+        auto& t{ *e.source };
+
+        // semaphore isn't destroyed while it's waited for, destroyed timeline has already reached all its values
+        std::scoped_lock const lock{ t.mutex };
+        if (t.completed.load(std::memory_order_relaxed) >= e.value)
+        {
+            continue;
+        }
+
+        vk::SemaphoreWaitInfo const wait_info{ .semaphoreCount = 1, .pSemaphores = &t.semaphore, .pValues = &e.value };
+        auto const result{ t.vk_device.waitSemaphores(wait_info, std::numeric_limits<std::uint64_t>::max(),
+                                                      *t.dispatcher) };
+        if (result != vk::Result::eSuccess)
+        {
+            throw error{ "deletion_queue::flush: waitSemaphores failed with: '{}'", vk::to_string(result) };
+        }
+
+        timeline::impl::update_cached(t, e.value);
+    }
+}
+catch (deletion_queue::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "deletion_queue::flush: Internal call to vulkan failed" });
+}
+
+std::size_t
+deletion_queue::size() const
+{
+    std::scoped_lock const lock{ data->shared->mutex };
+
+    return data->shared->entries.size();
+}
+
+} // namespace orbi
@@ -0,0 +1,335 @@
+#include <orbi/deletion_queue.hpp>
+#include <orbi/descriptor_heap.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/renderer.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace orbi
+{
+
+namespace
+{
+
+void
+free_slot(descriptor_heap::impl::state& s, vk::DescriptorType const type, std::uint32_t const index)
+{
+    std::scoped_lock const lock{ s.mutex };
+    s.of(type).free.push_back(index);
+}
+
+// returns index to its slots when destroyed by `deletion_queue`
+struct deferred_release
+{
+    deferred_release(std::shared_ptr<descriptor_heap::impl::state> s, vk::DescriptorType const t,
+                     std::uint32_t const i) noexcept
+        : shared{ std::move(s) }
+        , type{ t }
+        , index{ i }
+    {
+    }
+
+    deferred_release(deferred_release&&) noexcept = default;
+    deferred_release& operator=(deferred_release&&) = delete;
+
+    ~deferred_release()
+    {
+        if (!shared)
+        {
+            return;
+        }
+
+        free_slot(*shared, type, index);
+    }
+
+    std::shared_ptr<descriptor_heap::impl::state> shared;
+    vk::DescriptorType type;
+    std::uint32_t index;
+};
+
+std::uint32_t
+acquire(descriptor_heap::impl::slots& s, char const* const what)
+{
+    if (!s.free.empty())
+    {
+        auto const index{ s.free.back() };
+        s.free.pop_back();
+
+        return index;
+    }
+
+    if (s.next == s.capacity)
+    {
+        throw descriptor_heap::error{ "descriptor_heap::add: all {} slots for {} are used", s.capacity, what };
+    }
+
+    return s.next++;
+}
+
+/*
+    bindings are visible to all stages, so per stage limits apply too,
+    the limit of all resources of stage is shared in proportion to requested counts
+*/
+descriptor_heap_capacity
+fit_to_limits(descriptor_heap_capacity c, vk::PhysicalDeviceVulkan12Properties const& limits) noexcept
+{
+    c.sampled_images = std::min({ c.sampled_images, limits.maxDescriptorSetUpdateAfterBindSampledImages,
+                                  limits.maxPerStageDescriptorUpdateAfterBindSampledImages });
+    c.storage_buffers = std::min({ c.storage_buffers, limits.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                                   limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers });
+    c.samplers = std::min({ c.samplers, limits.maxDescriptorSetUpdateAfterBindSamplers,
+                            limits.maxPerStageDescriptorUpdateAfterBindSamplers });
+
+    auto const total{ std::uint64_t{ c.sampled_images } + c.storage_buffers + c.samplers };
+    auto const max_total{ std::uint64_t{ limits.maxPerStageUpdateAfterBindResources } };
+    if (total > max_total)
+    {
+        auto const scale = [&](std::uint32_t const count)
+        { return std::max(static_cast<std::uint32_t>(count * max_total / total), 1u); };
+
+        c.sampled_images = scale(c.sampled_images);
+        c.storage_buffers = scale(c.storage_buffers);
+        c.samplers = scale(c.samplers);
+    }
+
+    return c;
+}
+
+// descriptor is written under lock, because host access to descriptor set must be externally synchronized
+template <class Info>
+std::uint32_t
+write_descriptor(descriptor_heap::impl const& h, vk::DescriptorType const type, std::uint32_t const binding,
+                 Info const& info, char const* const what)
+{
+    auto& shared{ *h.shared };
+    std::scoped_lock const lock{ shared.mutex };
+
+    auto const index{ acquire(shared.of(type), what) };
+
+    vk::WriteDescriptorSet write_info{
+        .dstSet = h.set, .dstBinding = binding, .dstArrayElement = index, .descriptorCount = 1, .descriptorType = type
+    };
+
+    if constexpr (std::is_same_v<Info, vk::DescriptorBufferInfo>)
+    {
+        write_info.pBufferInfo = &info;
+    } else
+    {
+        write_info.pImageInfo = &info;
+    }
+
+    h.vk_device.updateDescriptorSets(write_info, {}, *h.dispatcher);
+
+    return index;
+}
+
+} // namespace
+
+descriptor_heap::descriptor_heap(device const& dev, descriptor_heap_capacity const& capacity)
+try
+{
+    assert(dev.bindless());
+    assert(capacity.sampled_images > 0 && capacity.storage_buffers > 0 && capacity.samplers > 0);
+
+    auto const& dev_impl{ device::impl::from_device(dev) };
+    auto const& vk_device{ dev_impl.vk_device };
+
+    auto const limits{ dev_impl.vk_physical_device
+                           .getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>()
+                           .get<vk::PhysicalDeviceVulkan12Properties>() };
+
+    auto const fitted{ fit_to_limits(capacity, limits) };
+
+    data->vk_device = *vk_device;
+    data->dispatcher = vk_device.getDispatcher();
+    data->deletion = dev_impl.deletion.get();
+
+    std::array const bindings{
+        vk::DescriptorSetLayoutBinding{ .binding = sampled_image_binding,
+                                        .descriptorType = vk::DescriptorType::eSampledImage,
+                                        .descriptorCount = fitted.sampled_images,
+                                        .stageFlags = vk::ShaderStageFlagBits::eAll },
+        vk::DescriptorSetLayoutBinding{ .binding = storage_buffer_binding,
+                                        .descriptorType = vk::DescriptorType::eStorageBuffer,
+                                        .descriptorCount = fitted.storage_buffers,
+                                        .stageFlags = vk::ShaderStageFlagBits::eAll },
+        vk::DescriptorSetLayoutBinding{ .binding = sampler_binding,
+                                        .descriptorType = vk::DescriptorType::eSampler,
+                                        .descriptorCount = fitted.samplers,
+                                        .stageFlags = vk::ShaderStageFlagBits::eAll },
+    };
+
+    // descriptors may be written while set is bound and used by gpu, unused ones needn't be valid
+    vk::DescriptorBindingFlags const binding_flag{ vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                                   vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending |
+                                                   vk::DescriptorBindingFlagBits::ePartiallyBound };
+    std::array const binding_flags{ binding_flag, binding_flag, binding_flag };
+
+    vk::DescriptorSetLayoutBindingFlagsCreateInfo const flags_info{ .bindingCount = binding_flags.size(),
+                                                                    .pBindingFlags = binding_flags.data() };
+
+    data->set_layout = vk::raii::DescriptorSetLayout{
+        vk_device,
+        vk::DescriptorSetLayoutCreateInfo{ .pNext = &flags_info,
+                                           .flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+                                           .bindingCount = bindings.size(),
+                                           .pBindings = bindings.data() }
+    };
+
+    std::array const pool_sizes{
+        vk::DescriptorPoolSize{ .type = vk::DescriptorType::eSampledImage, .descriptorCount = fitted.sampled_images },
+        vk::DescriptorPoolSize{ .type = vk::DescriptorType::eStorageBuffer,
+                                .descriptorCount = fitted.storage_buffers },
+        vk::DescriptorPoolSize{ .type = vk::DescriptorType::eSampler, .descriptorCount = fitted.samplers },
+    };
+
+    data->pool = vk::raii::DescriptorPool{
+        vk_device, vk::DescriptorPoolCreateInfo{ .flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+                                                 .maxSets = 1,
+                                                 .poolSizeCount = pool_sizes.size(),
+                                                 .pPoolSizes = pool_sizes.data() }
+    };
+
+    auto const set_layout{ *data->set_layout };
+    data->set = (*vk_device).allocateDescriptorSets({ .descriptorPool = data->pool,
+                                                      .descriptorSetCount = 1,
+                                                      .pSetLayouts = &set_layout },
+                                                    *vk_device.getDispatcher())
+                    .front();
+
+    vk::PushConstantRange const push_constants{ .stageFlags = vk::ShaderStageFlagBits::eAll,
+                                                .offset = 0,
+                                                .size = push_constant_size };
+
+    data->pipeline_layout = vk::raii::PipelineLayout{
+        vk_device, vk::PipelineLayoutCreateInfo{ .setLayoutCount = 1,
+                                                 .pSetLayouts = &set_layout,
+                                                 .pushConstantRangeCount = 1,
+                                                 .pPushConstantRanges = &push_constants }
+    };
+
+    data->shared = std::make_shared<impl::state>();
+    data->shared->sampled_images.capacity = fitted.sampled_images;
+    data->shared->storage_buffers.capacity = fitted.storage_buffers;
+    data->shared->samplers.capacity = fitted.samplers;
+
+    dev_impl.set_name(set_layout, "orbi::descriptor_heap set layout");
+    dev_impl.set_name(data->set, "orbi::descriptor_heap set");
+    dev_impl.set_name(*data->pipeline_layout, "orbi::descriptor_heap pipeline layout");
+}
+catch (descriptor_heap::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "descriptor_heap::descriptor_heap: Internal call to vulkan failed" });
+}
+
+descriptor_heap::~descriptor_heap() = default;
+
+descriptor_heap::descriptor_heap(descriptor_heap&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+descriptor_heap&
+descriptor_heap::operator=(descriptor_heap other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(descriptor_heap& l, descriptor_heap& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+sampled_image_handle
+descriptor_heap::add(vk::ImageView const view, vk::ImageLayout const layout)
+{
+    vk::DescriptorImageInfo const info{ .imageView = view, .imageLayout = layout };
+
+    return { .index = write_descriptor(*data, sampled_image_handle::type, sampled_image_binding, info,
+                                       "sampled images") };
+}
+
+storage_buffer_handle
+descriptor_heap::add(vk::Buffer const buffer, vk::DeviceSize const offset, vk::DeviceSize const range)
+{
+    vk::DescriptorBufferInfo const info{ .buffer = buffer, .offset = offset, .range = range };
+
+    return { .index = write_descriptor(*data, storage_buffer_handle::type, storage_buffer_binding, info,
+                                       "storage buffers") };
+}
+
+sampler_handle
+descriptor_heap::add(vk::Sampler const sampler)
+{
+    vk::DescriptorImageInfo const info{ .sampler = sampler };
+
+    return { .index = write_descriptor(*data, sampler_handle::type, sampler_binding, info, "samplers") };
+}
+
+void
+descriptor_heap::release(vk::DescriptorType const type, std::uint32_t const index)
+{
+    assert(index != sampled_image_handle::invalid_index);
+
+    free_slot(*data->shared, type, index);
+}
+
+void
+descriptor_heap::release(vk::DescriptorType const type, std::uint32_t const index, renderer const& r)
+{
+    assert(index != sampled_image_handle::invalid_index);
+
+    data->deletion->push(r, deferred_release{ data->shared, type, index });
+}
+
+descriptor_heap_capacity
+descriptor_heap::capacity() const noexcept
+{
+    return { .sampled_images = data->shared->sampled_images.capacity,
+             .storage_buffers = data->shared->storage_buffers.capacity,
+             .samplers = data->shared->samplers.capacity };
+}
+
+vk::DescriptorSetLayout
+descriptor_heap::set_layout() const noexcept
+{
+    return data->set_layout;
+}
+
+vk::DescriptorSet
+descriptor_heap::set() const noexcept
+{
+    return data->set;
+}
+
+vk::PipelineLayout
+descriptor_heap::pipeline_layout() const noexcept
+{
+    return data->pipeline_layout;
+}
+
+void
+descriptor_heap::bind(vk::raii::CommandBuffer const& command_buffer, vk::PipelineBindPoint const bind_point) const
+{
+    command_buffer.bindDescriptorSets(bind_point, data->pipeline_layout, 0, data->set, {});
+}
+
+} // namespace orbi
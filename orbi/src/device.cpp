@@ -1,96 +1,605 @@
 #include <orbi/context.hpp>
+#include <orbi/deletion_queue.hpp>
+#include <orbi/descriptor_heap.hpp>
 #include <orbi/detail/impl.hpp>
 #include <orbi/device.hpp>
+#include <orbi/gpu_allocator.hpp>
+#include <orbi/pipeline_cache.hpp>
+#include <orbi/trace.hpp>
 #include <orbi/window.hpp>
 
+#include <SDL3/SDL_stdinc.h>
+
 #include <vulkan/vulkan_raii.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <cctype>
+#include <format>
+#include <iterator>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
 
 namespace orbi
 {
 
-device::device(context const& ctx, window const& win)
+namespace
 {
-    auto const& ctx_impl{ context::impl::from_ctx(ctx) };
-    auto const& win_impl{ window::impl::from_window(win) };
-    auto const& vulkan_instance{ ctx_impl.vulkan_instance };
 
-    data->vk_physical_device =
-        vk::raii::PhysicalDevice(vulkan_instance, *vulkan_instance.enumeratePhysicalDevices().at(0));
+using queue_family_index_type = device::impl::queue_family_index_type;
+
+// features needed by `descriptor_heap`, see `device_options::bindless`
+vk::PhysicalDeviceVulkan12Features
+bindless_features() noexcept
+{
+    return { .shaderSampledImageArrayNonUniformIndexing = vk::True,
+             .shaderStorageBufferArrayNonUniformIndexing = vk::True,
+             .descriptorBindingSampledImageUpdateAfterBind = vk::True,
+             .descriptorBindingStorageBufferUpdateAfterBind = vk::True,
+             .descriptorBindingUpdateUnusedWhilePending = vk::True,
+             .descriptorBindingPartiallyBound = vk::True,
+             .runtimeDescriptorArray = vk::True };
+}
+
+bool
+has_bindless_features(vk::PhysicalDeviceVulkan12Features const& f) noexcept
+{
+    return f.shaderSampledImageArrayNonUniformIndexing && f.shaderStorageBufferArrayNonUniformIndexing &&
+           f.descriptorBindingSampledImageUpdateAfterBind && f.descriptorBindingStorageBufferUpdateAfterBind &&
+           f.descriptorBindingUpdateUnusedWhilePending && f.descriptorBindingPartiallyBound &&
+           f.runtimeDescriptorArray;
+}
 
-    data->graphics_queue_family_index = [&]
+// `device_options::required_features` with ones needed by options
+vk::PhysicalDeviceFeatures
+enabled_features(device_options const& options) noexcept
+{
+    auto features{ options.required_features };
+
+    // draws of `indirect_draws` are many per call and pass index of object as first instance
+    if (options.indirect_draw)
     {
-        auto const queue_families{ data->vk_physical_device.getQueueFamilyProperties() };
-        auto const it{ std::ranges::find_if(queue_families,
-                                            [](auto const props)
-                                            {
-                                                return static_cast<bool>(props.queueFlags &
-                                                                         vk::QueueFlagBits::eGraphics);
-                                            }) };
+        features.multiDrawIndirect = vk::True;
+        features.drawIndirectFirstInstance = vk::True;
+    }
 
-        assert(it != end(queue_families));
+    return features;
+}
 
-        return it - begin(queue_families);
-    }();
+struct evaluation
+{
+    device_candidate candidate;
+    vk::raii::PhysicalDevice physical_device{ nullptr };
+    queue_family_index_type graphics_queue_family_index{ 0 };
+    queue_family_index_type present_queue_family_index{ 0 };
+    std::optional<queue_family_index_type> compute_queue_family_index;
+    std::optional<queue_family_index_type> transfer_queue_family_index;
+};
+
+struct device_override
+{
+    std::string value;
+    std::optional<std::string> name;
+    std::optional<device_uuid> uuid;
+};
 
-    auto* const surface{ win_impl.vk_surface };
+std::uint64_t
+type_rank(vk::PhysicalDeviceType const type)
+{
+    switch (type)
+    {
+    case vk::PhysicalDeviceType::eDiscreteGpu:
+        return 4;
+    case vk::PhysicalDeviceType::eIntegratedGpu:
+        return 3;
+    case vk::PhysicalDeviceType::eVirtualGpu:
+        return 2;
+    case vk::PhysicalDeviceType::eCpu:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+bool
+has_features(vk::PhysicalDeviceFeatures const& available, vk::PhysicalDeviceFeatures const& required)
+{
+    // `VkPhysicalDeviceFeatures` consists only of `VkBool32` members
+    constexpr auto count{ sizeof(vk::PhysicalDeviceFeatures) / sizeof(vk::Bool32) };
+    static_assert(count * sizeof(vk::Bool32) == sizeof(vk::PhysicalDeviceFeatures));
+
+    auto const* const available_bits{ reinterpret_cast<vk::Bool32 const*>(&available) };
+    auto const* const required_bits{ reinterpret_cast<vk::Bool32 const*>(&required) };
 
-    data->present_queue_family_index = [&]
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    for (std::size_t i{ 0 }; i < count; ++i)
     {
-        auto const queue_families{ data->vk_physical_device.getQueueFamilyProperties() };
-        auto const it{ std::ranges::find_if(queue_families,
-                                            [&, i = 0](auto const) mutable
-                                            {
-                                                return data->vk_physical_device.getSurfaceSupportKHR(i++, surface);
-                                            }) };
+        if (required_bits[i] && !available_bits[i])
+        {
+            return false;
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 
-        assert(it != end(queue_families));
+    return true;
+}
 
-        return it - begin(queue_families);
-    }();
+/*
+    @return family, which supports `required` and doesn't support any of `excluded`
+*/
+std::optional<queue_family_index_type>
+find_dedicated_family(std::vector<vk::QueueFamilyProperties> const& queue_families,
+                      vk::QueueFlags const required, vk::QueueFlags const excluded)
+{
+    auto const it{ std::ranges::find_if(queue_families,
+                                        [&](auto const& props)
+                                        {
+                                            return (props.queueFlags & required) == required &&
+                                                   !(props.queueFlags & excluded);
+                                        }) };
 
-    std::vector const unique_queue_families = [&]
+    if (it == end(queue_families))
     {
-        std::vector families{ data->graphics_queue_family_index, data->present_queue_family_index };
-        std::ranges::sort(families);
-        auto const [first, last] = std::ranges::unique(families);
-        families.erase(first, last);
+        return std::nullopt;
+    }
 
-        return families;
-    }();
+    return static_cast<queue_family_index_type>(it - begin(queue_families));
+}
+
+/*
+    null `surface` means headless device: swapchain isn't needed and present queue is the graphics one
+*/
+evaluation
+evaluate(vk::raii::PhysicalDevice physical_device, VkSurfaceKHR const surface, device_options const& options)
+{
+    evaluation e{ .physical_device = std::move(physical_device) };
+    auto& c{ e.candidate };
+    auto const& pd{ e.physical_device };
+
+    auto const properties_chain{ pd.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>() };
+    auto const& properties{ properties_chain.get<vk::PhysicalDeviceProperties2>().properties };
+
+    c.name = properties.deviceName.data();
+    c.uuid = properties_chain.get<vk::PhysicalDeviceIDProperties>().deviceUUID;
+    c.type = properties.deviceType;
+
+    if (properties.apiVersion < VK_API_VERSION_1_3)
+    {
+        c.rejection_reasons.push_back(std::format("supports only vulkan {}.{}, but 1.3 is required",
+                                                  VK_API_VERSION_MAJOR(properties.apiVersion),
+                                                  VK_API_VERSION_MINOR(properties.apiVersion)));
+    }
+
+    auto const available_extensions{ pd.enumerateDeviceExtensionProperties() };
+    auto const check_extension = [&](std::string_view const name)
+    {
+        auto const found{ std::ranges::any_of(available_extensions, [&](auto const& ext)
+                                              { return name == ext.extensionName.data(); }) };
+        if (!found)
+        {
+            c.rejection_reasons.push_back(std::format("extension '{}' is not supported", name));
+        }
+    };
+
+    if (surface)
+    {
+        check_extension(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
+    if (options.external_memory)
+    {
+        check_extension(VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME);
+        check_extension(VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME);
+    }
+    std::ranges::for_each(options.required_extensions, check_extension);
+
+    if (!has_features(pd.getFeatures(), enabled_features(options)))
+    {
+        c.rejection_reasons.emplace_back("some of required features are not supported");
+    }
+
+    if (properties.apiVersion >= VK_API_VERSION_1_3)
+    {
+        auto const chain{ pd.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features,
+                                          vk::PhysicalDeviceVulkan13Features>() };
+        auto const& features{ chain.get<vk::PhysicalDeviceVulkan13Features>() };
+
+        if (!features.dynamicRendering || !features.synchronization2)
+        {
+            c.rejection_reasons.emplace_back("dynamic rendering or synchronization2 is not supported");
+        }
+
+        auto const& vulkan12{ chain.get<vk::PhysicalDeviceVulkan12Features>() };
+        if (!vulkan12.timelineSemaphore)
+        {
+            c.rejection_reasons.emplace_back("timeline semaphores are not supported");
+        }
+
+        if (options.bindless && !has_bindless_features(vulkan12))
+        {
+            c.rejection_reasons.emplace_back("descriptor indexing with update after bind is not supported");
+        }
+
+        if (options.indirect_draw && !vulkan12.drawIndirectCount)
+        {
+            c.rejection_reasons.emplace_back("draw indirect count is not supported");
+        }
+    }
+
+    auto const queue_families{ pd.getQueueFamilyProperties() };
+    std::optional<queue_family_index_type> graphics;
+    std::optional<queue_family_index_type> present;
+
+    for (queue_family_index_type i{ 0 }; i < queue_families.size(); ++i)
+    {
+        auto const is_graphics{ static_cast<bool>(queue_families[i].queueFlags & vk::QueueFlagBits::eGraphics) };
+        auto const is_present{ surface ? pd.getSurfaceSupportKHR(i, surface) == vk::True : is_graphics };
+
+        // prefer the same family for both, so swapchain images needn't be shared
+        if (is_graphics && is_present)
+        {
+            graphics = present = i;
+            break;
+        }
+
+        if (is_graphics && !graphics)
+        {
+            graphics = i;
+        }
+
+        if (is_present && !present)
+        {
+            present = i;
+        }
+    }
+
+    if (!graphics)
+    {
+        c.rejection_reasons.emplace_back("there is no queue family with graphics support");
+    }
+
+    if (surface && !present)
+    {
+        c.rejection_reasons.emplace_back("there is no queue family which can present to window surface");
+    } else if (surface &&
+               (pd.getSurfaceFormatsKHR(surface).empty() || pd.getSurfacePresentModesKHR(surface).empty()))
+    {
+        c.rejection_reasons.emplace_back("window surface has no formats or present modes");
+    }
+
+    if (!c.suitable())
+    {
+        return e;
+    }
+
+    e.graphics_queue_family_index = *graphics;
+    e.present_queue_family_index = *present;
+    e.compute_queue_family_index = find_dedicated_family(queue_families, vk::QueueFlagBits::eCompute,
+                                                         vk::QueueFlagBits::eGraphics);
+
+    // family without graphics and compute is usually backed by dma engine, so it is preferred
+    e.transfer_queue_family_index = find_dedicated_family(
+        queue_families, vk::QueueFlagBits::eTransfer, vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute);
+    if (!e.transfer_queue_family_index)
+    {
+        e.transfer_queue_family_index =
+            find_dedicated_family(queue_families, vk::QueueFlagBits::eTransfer, vk::QueueFlagBits::eGraphics);
+    }
+
+    auto const memory{ pd.getMemoryProperties() };
+    std::uint64_t device_local_mib{ 0 };
+    for (auto const& heap : std::span{ memory.memoryHeaps.data(), memory.memoryHeapCount })
+    {
+        if (heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+        {
+            device_local_mib += heap.size / (1024 * 1024);
+        }
+    }
+
+    // device type always outweighs memory size, `+ 1` keeps suitable devices above rejected ones
+    std::uint64_t constexpr type_weight{ 1ull << 40 };
+    c.score = type_rank(c.type) * type_weight + device_local_mib + 1;
+
+    return e;
+}
+
+std::vector<evaluation>
+evaluate_all(context::impl const& ctx, VkSurfaceKHR const surface, device_options const& options)
+{
+    std::vector<evaluation> evaluations;
+
+    for (auto& pd : ctx.vulkan_instance.enumeratePhysicalDevices())
+    {
+        evaluations.push_back(evaluate(std::move(pd), surface, options));
+    }
+
+    std::ranges::stable_sort(evaluations, std::ranges::greater{}, [](auto const& e) { return e.candidate.score; });
+
+    return evaluations;
+}
+
+std::optional<device_uuid>
+parse_uuid(std::string_view const str)
+{
+    std::string hex;
+    std::ranges::copy_if(str, std::back_inserter(hex), [](char const ch) { return ch != '-'; });
+
+    if (hex.size() != 2 * std::tuple_size_v<device_uuid> ||
+        !std::ranges::all_of(hex, [](unsigned char const ch) { return std::isxdigit(ch); }))
+    {
+        return std::nullopt;
+    }
+
+    device_uuid uuid{};
+    for (std::size_t i{ 0 }; i < uuid.size(); ++i)
+    {
+        uuid[i] = static_cast<std::uint8_t>(std::stoul(hex.substr(2 * i, 2), nullptr, 16));
+    }
+
+    return uuid;
+}
+
+std::string
+to_string(device_uuid const& uuid)
+{
+    std::string str;
+    for (auto const byte : uuid)
+    {
+        str += std::format("{:02x}", byte);
+    }
+
+    return str;
+}
+
+std::optional<device_override>
+find_override(device_options const& options)
+{
+    if (!options.override_env.empty())
+    {
+        if (char const* const env{ SDL_getenv(options.override_env.c_str()) }; env && *env)
+        {
+            device_override o{ .value = env };
+            o.uuid = parse_uuid(o.value);
+            if (!o.uuid)
+            {
+                o.name = o.value;
+            }
+
+            return o;
+        }
+    }
+
+    if (options.preferred_uuid)
+    {
+        return device_override{ .value = to_string(*options.preferred_uuid), .uuid = options.preferred_uuid };
+    }
+
+    if (options.preferred_name)
+    {
+        return device_override{ .value = *options.preferred_name, .name = options.preferred_name };
+    }
+
+    return std::nullopt;
+}
+
+bool
+matches(device_candidate const& c, device_override const& o)
+{
+    if (o.uuid)
+    {
+        return c.uuid == *o.uuid;
+    }
+
+    return o.name && c.name.find(*o.name) != std::string::npos;
+}
+
+std::string
+make_report(std::vector<evaluation> const& evaluations)
+{
+    std::ostringstream report;
+
+    for (auto const& e : evaluations)
+    {
+        auto const& c{ e.candidate };
+
+        report << std::format("\n\t'{}' ({}, uuid {}): ", c.name, vk::to_string(c.type), to_string(c.uuid));
+
+        if (c.suitable())
+        {
+            report << std::format("score {}", c.score);
+            continue;
+        }
+
+        report << "rejected:";
+        for (auto const& reason : c.rejection_reasons)
+        {
+            report << "\n\t\t" << reason;
+        }
+    }
+
+    return report.str();
+}
+
+evaluation
+select_physical_device(context::impl const& ctx, VkSurfaceKHR const surface, device_options const& options)
+{
+    auto evaluations{ evaluate_all(ctx, surface, options) };
+    auto const o{ find_override(options) };
+
+    auto const it{ std::ranges::find_if(evaluations, [&](auto const& e)
+                                        { return e.candidate.suitable() && (!o || matches(e.candidate, *o)); }) };
+
+    if (it == end(evaluations))
+    {
+        if (o)
+        {
+            throw device::error{ "device::device: there is no suitable physical device matching '{}':{}",
+                                 o->value, make_report(evaluations) };
+        }
+
+        throw device::error{ "device::device: there is no suitable physical device:{}", make_report(evaluations) };
+    }
+
+    return std::move(*it);
+}
+
+} // namespace
+
+device::device(context const& ctx, window const& win, device_options const& options)
+    : device{ ctx, window::impl::from_window(win).vk_surface, options }
+{
+}
+
+device::device(context const& ctx, device_options const& options)
+    : device{ ctx, VkSurfaceKHR{}, options }
+{
+}
+
+device::device(context const& ctx, VkSurfaceKHR const surface, device_options const& options)
+try
+{
+    ORBI_TRACE_SCOPE("device::device");
+
+    auto const& ctx_impl{ context::impl::from_ctx(ctx) };
+
+    auto selected{ select_physical_device(ctx_impl, surface, options) };
+
+    data->vk_physical_device = std::move(selected.physical_device);
+    data->headless = !surface;
+    data->external_memory = options.external_memory;
+    data->bindless = options.bindless;
+    data->indirect_draw = options.indirect_draw;
+    data->debug_markers = ctx_impl.instrumentation_level >= instrumentation::markers;
+
+    auto const graphics_family{ selected.graphics_queue_family_index };
+    auto const present_family{ selected.present_queue_family_index };
+    auto const compute_family{ selected.compute_queue_family_index.value_or(graphics_family) };
+    auto const transfer_family{ selected.transfer_queue_family_index.value_or(graphics_family) };
+
+    // queues sharing family get distinct `VkQueue`s while family has enough of them,
+    // the rest alias the last one and must be externally synchronized with it
+    auto const queue_family_properties{ data->vk_physical_device.getQueueFamilyProperties() };
+    std::vector<std::uint32_t> queue_counts(queue_family_properties.size(), 0);
+
+    auto const next_queue_index = [&](queue_family_index_type const family)
+    {
+        auto& count{ queue_counts.at(family) };
+        auto const index{ std::min(count, queue_family_properties[family].queueCount - 1) };
+        count = std::max(count, index + 1);
+
+        return index;
+    };
+
+    // presentation is recorded by the thread, which submits graphics work, so they share queue
+    auto const graphics_index{ next_queue_index(graphics_family) };
+    auto const present_index{ present_family == graphics_family ? graphics_index : next_queue_index(present_family) };
+    auto const compute_index{ next_queue_index(compute_family) };
+    auto const transfer_index{ next_queue_index(transfer_family) };
 
     data->vk_device = [&]() -> vk::raii::Device
     {
-        float const queue_priority{ 1 };
+        // at most graphics, compute and transfer queues are taken from one family
+        std::array const queue_priorities{ 1.f, 1.f, 1.f };
 
         std::vector<vk::DeviceQueueCreateInfo> queue_create_infos;
-        for (auto const& qf : unique_queue_families)
+        for (queue_family_index_type qf{ 0 }; qf < queue_counts.size(); ++qf)
+        {
+            if (queue_counts[qf] > 0)
+            {
+                assert(queue_counts[qf] <= queue_priorities.size());
+                queue_create_infos.push_back({ .queueFamilyIndex = qf,
+                                               .queueCount = queue_counts[qf],
+                                               .pQueuePriorities = queue_priorities.data() });
+            }
+        }
+
+        std::vector<char const*> device_extensions;
+        if (surface)
+        {
+            device_extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        }
+
+        // `VK_KHR_external_memory` and `VK_KHR_external_semaphore` they depend on are core since 1.1
+        if (options.external_memory)
         {
-            queue_create_infos.push_back(
-                { .queueFamilyIndex = qf, .queueCount = 1, .pQueuePriorities = &queue_priority });
+            device_extensions.push_back(VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME);
+            device_extensions.push_back(VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME);
         }
 
-        std::array const device_extensions{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+        for (auto const& ext : options.required_extensions)
+        {
+            device_extensions.push_back(ext.c_str());
+        }
+
+        // frames and other gpu work are tracked by `orbi::timeline`
+        auto vulkan12_features{ options.bindless ? bindless_features() : vk::PhysicalDeviceVulkan12Features{} };
+        vulkan12_features.timelineSemaphore = vk::True;
+        vulkan12_features.drawIndirectCount = options.indirect_draw ? vk::True : vk::False;
+
+        auto const features{ enabled_features(options) };
+
+        // `orbi` records rendering only with `vkCmdBeginRendering` and `vkCmdPipelineBarrier2`
+        vk::PhysicalDeviceVulkan13Features const vulkan13_features{ .pNext = &vulkan12_features,
+                                                                    .synchronization2 = vk::True,
+                                                                    .dynamicRendering = vk::True };
 
         vk::DeviceCreateInfo const device_create_info{
+            .pNext = &vulkan13_features,
             .queueCreateInfoCount = static_cast<std::uint32_t>(queue_create_infos.size()),
             .pQueueCreateInfos = queue_create_infos.data(),
-            .enabledExtensionCount = device_extensions.size(),
-            .ppEnabledExtensionNames = device_extensions.data()
-
+            .enabledExtensionCount = static_cast<std::uint32_t>(device_extensions.size()),
+            .ppEnabledExtensionNames = device_extensions.data(),
+            .pEnabledFeatures = &features
         };
 
         return { data->vk_physical_device, device_create_info };
     }();
+
+    auto const make_queue = [&]<queue_type Type>(impl::queue<Type>& q, queue_family_index_type const family,
+                                                 std::uint32_t const index, std::string_view const name)
+    {
+        q.vk_queue = vk::raii::Queue{ data->vk_device, family, index };
+        q.family_index = family;
+        q.dedicated = family != graphics_family;
+        q.aliases_graphics = Type != queue_type::graphics && family == graphics_family && index == graphics_index;
+
+        // queue shared with graphics one keeps its name
+        if (!q.aliases_graphics)
+        {
+            data->set_name(*q.vk_queue, "orbi::device {} queue", name);
+        }
+    };
+
+    make_queue(data->graphics_queue, graphics_family, graphics_index, "graphics");
+    make_queue(data->present_queue, present_family, present_index, "present");
+    make_queue(data->compute_queue, compute_family, compute_index, "compute");
+    make_queue(data->transfer_queue, transfer_family, transfer_index, "transfer");
+
+    data->allocator = std::make_unique<gpu_allocator>(*this);
+    data->cache = std::make_unique<pipeline_cache>(*this, options.pipeline_cache_directory);
+    data->deletion = std::make_unique<deletion_queue>();
+
+    if (options.bindless)
+    {
+        data->descriptors = std::make_unique<descriptor_heap>(*this, options.descriptor_capacity);
+    }
+}
+catch (device::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "device::device: Internal call to vulkan failed" });
 }
 
 device::~device() = default;
 
 device::device(device&& other) noexcept
+    : data(std::move(*other.data))
 {
-    data->vk_physical_device = std::exchange(other.data->vk_physical_device, nullptr);
-    data->vk_device = std::exchange(other.data->vk_device, nullptr);
 }
 
 device&
@@ -109,10 +618,110 @@ swap(device& l, device& r) noexcept
     swap(*l.data, *r.data);
 }
 
+std::vector<device_candidate>
+device::candidates(context const& ctx, window const& win, device_options const& options)
+{
+    return candidates(ctx, window::impl::from_window(win).vk_surface, options);
+}
+
+std::vector<device_candidate>
+device::candidates(context const& ctx, device_options const& options)
+{
+    return candidates(ctx, VkSurfaceKHR{}, options);
+}
+
+std::vector<device_candidate>
+device::candidates(context const& ctx, VkSurfaceKHR const surface, device_options const& options)
+try
+{
+    auto const evaluations{ evaluate_all(context::impl::from_ctx(ctx), surface, options) };
+
+    std::vector<device_candidate> result;
+    result.reserve(evaluations.size());
+    for (auto const& e : evaluations)
+    {
+        result.push_back(e.candidate);
+    }
+
+    return result;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "device::candidates: Internal call to vulkan failed" });
+}
+
 void
 device::wait_until_idle() const
 {
     return data->vk_device.waitIdle();
 }
 
+bool
+device::has_dedicated_queue(queue_type const type) const noexcept
+{
+    switch (type)
+    {
+    case queue_type::graphics:
+        return data->graphics_queue.dedicated;
+    case queue_type::present:
+        return data->present_queue.dedicated;
+    case queue_type::compute:
+        return data->compute_queue.dedicated;
+    case queue_type::transfer:
+        return data->transfer_queue.dedicated;
+    }
+
+    detail::unreachable();
+}
+
+bool
+device::headless() const noexcept
+{
+    return data->headless;
+}
+
+bool
+device::external_memory() const noexcept
+{
+    return data->external_memory;
+}
+
+bool
+device::bindless() const noexcept
+{
+    return data->bindless;
+}
+
+bool
+device::indirect_draw() const noexcept
+{
+    return data->indirect_draw;
+}
+
+gpu_allocator&
+device::allocator() const noexcept
+{
+    return *data->allocator;
+}
+
+pipeline_cache&
+device::cache() const noexcept
+{
+    return *data->cache;
+}
+
+deletion_queue&
+device::deletion() const noexcept
+{
+    return *data->deletion;
+}
+
+descriptor_heap&
+device::descriptors() const noexcept
+{
+    assert(data->descriptors);
+
+    return *data->descriptors;
+}
+
 } // namespace orbi
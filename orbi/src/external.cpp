@@ -0,0 +1,167 @@
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/external.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <utility>
+
+namespace orbi
+{
+
+namespace
+{
+
+vk::ImageMemoryBarrier2
+external_barrier(vk::Image const image)
+{
+    return { .image = image,
+             .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                   .baseMipLevel = 0,
+                                   .levelCount = vk::RemainingMipLevels,
+                                   .baseArrayLayer = 0,
+                                   .layerCount = vk::RemainingArrayLayers } };
+}
+
+} // namespace
+
+external_semaphore::external_semaphore(device const& dev)
+try
+{
+    assert(dev.external_memory());
+
+    auto const& dev_impl{ device::impl::from_device(dev) };
+
+    auto const supported = [&](vk::ExternalSemaphoreHandleTypeFlagBits const type)
+    {
+        auto const features{ dev_impl.vk_physical_device.getExternalSemaphoreProperties({ .handleType = type })
+                                 .externalSemaphoreFeatures };
+
+        return (features & vk::ExternalSemaphoreFeatureFlagBits::eExportable) &&
+               (features & vk::ExternalSemaphoreFeatureFlagBits::eImportable);
+    };
+
+    // sync fd can be waited on by anything, which understands fences of kernel, e.g. compositor
+    std::array constexpr preferred{ vk::ExternalSemaphoreHandleTypeFlagBits::eSyncFd,
+                                    vk::ExternalSemaphoreHandleTypeFlagBits::eOpaqueFd };
+
+    auto const it{ std::ranges::find_if(preferred, supported) };
+    if (it == end(preferred))
+    {
+        throw error{ "external_semaphore::external_semaphore: device can't export nor import semaphore as fd" };
+    }
+
+    data->handle_type = *it;
+
+    vk::ExportSemaphoreCreateInfo const export_info{ .handleTypes = data->handle_type };
+    data->semaphore = vk::raii::Semaphore{ dev_impl.vk_device, vk::SemaphoreCreateInfo{ .pNext = &export_info } };
+    dev_impl.set_name(*data->semaphore, "orbi::external_semaphore ({})", vk::to_string(data->handle_type));
+}
+catch (external_semaphore::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "external_semaphore::external_semaphore: Internal call to vulkan failed" });
+}
+
+external_semaphore::~external_semaphore() = default;
+
+external_semaphore::external_semaphore(external_semaphore&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+external_semaphore&
+external_semaphore::operator=(external_semaphore other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(external_semaphore& l, external_semaphore& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+vk::Semaphore
+external_semaphore::semaphore() const noexcept
+{
+    return data->semaphore;
+}
+
+vk::ExternalSemaphoreHandleTypeFlagBits
+external_semaphore::handle_type() const noexcept
+{
+    return data->handle_type;
+}
+
+int
+external_semaphore::export_fd() const
+try
+{
+    return data->semaphore.getDevice().getSemaphoreFdKHR(
+        { .semaphore = data->semaphore, .handleType = data->handle_type }, *data->semaphore.getDispatcher());
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "external_semaphore::export_fd: Internal call to vulkan failed" });
+}
+
+void
+external_semaphore::import_fd(int const fd)
+try
+{
+    // sync fd supports only temporary import
+    auto const flags{ data->handle_type == vk::ExternalSemaphoreHandleTypeFlagBits::eSyncFd
+                          ? vk::SemaphoreImportFlagBits::eTemporary
+                          : vk::SemaphoreImportFlags{} };
+
+    data->semaphore.getDevice().importSemaphoreFdKHR(
+        { .semaphore = data->semaphore, .flags = flags, .handleType = data->handle_type, .fd = fd },
+        *data->semaphore.getDispatcher());
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "external_semaphore::import_fd: Internal call to vulkan failed" });
+}
+
+void
+release_to_external(device const& dev, vk::raii::CommandBuffer const& command_buffer, vk::Image const image,
+                    image_state const& from, vk::ImageLayout const layout)
+{
+    auto barrier{ external_barrier(image) };
+    barrier.srcStageMask = from.stage;
+    barrier.srcAccessMask = from.access;
+    barrier.oldLayout = from.layout;
+    barrier.newLayout = layout;
+    barrier.srcQueueFamilyIndex = device::impl::from_device(dev).graphics_queue.family_index;
+    barrier.dstQueueFamilyIndex = vk::QueueFamilyExternal;
+
+    command_buffer.pipelineBarrier2({ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &barrier });
+}
+
+void
+acquire_from_external(device const& dev, vk::raii::CommandBuffer const& command_buffer, vk::Image const image,
+                      vk::ImageLayout const layout, image_state const& to)
+{
+    auto barrier{ external_barrier(image) };
+    barrier.dstStageMask = to.stage;
+    barrier.dstAccessMask = to.access;
+    barrier.oldLayout = layout;
+    barrier.newLayout = to.layout;
+    barrier.srcQueueFamilyIndex = vk::QueueFamilyExternal;
+    barrier.dstQueueFamilyIndex = device::impl::from_device(dev).graphics_queue.family_index;
+
+    command_buffer.pipelineBarrier2({ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &barrier });
+}
+
+} // namespace orbi
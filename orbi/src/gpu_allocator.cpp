@@ -0,0 +1,389 @@
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/gpu_allocator.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace orbi
+{
+
+namespace
+{
+
+struct memory_flags
+{
+    vk::MemoryPropertyFlags required;
+    vk::MemoryPropertyFlags preferred;
+};
+
+memory_flags
+flags_of(memory_usage const usage)
+{
+    using enum vk::MemoryPropertyFlagBits;
+
+    switch (usage)
+    {
+    case memory_usage::gpu_only:
+        return { .required = {}, .preferred = eDeviceLocal };
+    case memory_usage::upload:
+        return { .required = eHostVisible | eHostCoherent, .preferred = {} };
+    case memory_usage::readback:
+        return { .required = eHostVisible | eHostCoherent, .preferred = eHostCached };
+    }
+
+    detail::unreachable();
+}
+
+std::uint32_t
+find_memory_type(gpu_allocator::impl const& a, std::uint32_t const type_bits, memory_usage const usage)
+{
+    auto const [required, preferred] = flags_of(usage);
+    auto const& props{ a.memory_properties };
+
+    auto const find = [&](vk::MemoryPropertyFlags const flags) -> std::optional<std::uint32_t>
+    {
+        for (std::uint32_t i{ 0 }; i < props.memoryTypeCount; ++i)
+        {
+            if ((type_bits & (1u << i)) && (props.memoryTypes[i].propertyFlags & flags) == flags)
+            {
+                return i;
+            }
+        }
+
+        return std::nullopt;
+    };
+
+    if (auto const type{ find(required | preferred) })
+    {
+        return *type;
+    }
+
+    if (auto const type{ find(required) })
+    {
+        return *type;
+    }
+
+    throw gpu_allocator::error{ "gpu_allocator: there is no memory type with flags '{}' in bits '{:#b}'",
+                                vk::to_string(required), type_bits };
+}
+
+bool
+is_host_visible(gpu_allocator::impl const& a, std::uint32_t const memory_type)
+{
+    return static_cast<bool>(a.memory_properties.memoryTypes[memory_type].propertyFlags &
+                             vk::MemoryPropertyFlagBits::eHostVisible);
+}
+
+std::byte*
+map(gpu_allocator::impl const& a, vk::DeviceMemory const memory)
+{
+    return static_cast<std::byte*>(a.vk_device.mapMemory(memory, 0, vk::WholeSize, {}, *a.dispatcher));
+}
+
+vk::DeviceMemory
+allocate_memory(gpu_allocator::impl const& a, vk::MemoryAllocateInfo const& info)
+{
+    try
+    {
+        return a.vk_device.allocateMemory(info, nullptr, *a.dispatcher);
+    }
+    catch (vk::OutOfDeviceMemoryError const&)
+    {
+        throw gpu_allocator::error{ "gpu_allocator: out of device memory, allocating {} bytes of memory type {}",
+                                    info.allocationSize, info.memoryTypeIndex };
+    }
+    catch (vk::OutOfHostMemoryError const&)
+    {
+        throw gpu_allocator::error{ "gpu_allocator: out of host memory, allocating {} bytes of memory type {}",
+                                    info.allocationSize, info.memoryTypeIndex };
+    }
+}
+
+vk::DeviceSize
+block_size_of(gpu_allocator::impl const& a, std::uint32_t const memory_type)
+{
+    auto const heap_index{ a.memory_properties.memoryTypes[memory_type].heapIndex };
+    auto const heap_size{ a.memory_properties.memoryHeaps[heap_index].size };
+
+    // small heaps (e.g. 256 MiB bar window) must not be taken by one block
+    return std::min(a.block_size, heap_size / 8);
+}
+
+std::unique_ptr<gpu_allocator::impl::block>
+make_block(gpu_allocator::impl const& a, std::uint32_t const memory_type, vk::DeviceSize const size)
+{
+    auto const memory{ allocate_memory(a, { .allocationSize = size, .memoryTypeIndex = memory_type }) };
+
+    auto b{ std::make_unique<gpu_allocator::impl::block>(
+        gpu_allocator::impl::block{ .memory = memory, .mapped = nullptr, .ranges = detail::tlsf{ size } }) };
+
+    if (is_host_visible(a, memory_type))
+    {
+        try
+        {
+            b->mapped = map(a, memory);
+        }
+        catch (...)
+        {
+            a.vk_device.freeMemory(memory, nullptr, *a.dispatcher);
+            throw;
+        }
+    }
+
+    return b;
+}
+
+gpu_allocation
+make_allocation(gpu_allocator::impl::block const& b, detail::tlsf::allocation const& r, std::uint32_t const pool,
+                std::uint32_t const block)
+{
+    return { .memory = b.memory,
+             .offset = r.offset,
+             .size = r.size,
+             // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+             .mapped = b.mapped ? b.mapped + r.offset : nullptr,
+             .pool = pool,
+             .block = block,
+             .node = r.node };
+}
+
+gpu_allocation
+allocate_dedicated(gpu_allocator::impl& a, gpu_allocation_info const& info, std::uint32_t const memory_type)
+{
+    vk::MemoryDedicatedAllocateInfo const dedicated_info{ .image = info.dedicated_image,
+                                                          .buffer = info.dedicated_buffer };
+
+    bool const has_resource{ info.dedicated_image || info.dedicated_buffer };
+
+    auto const memory{ allocate_memory(a, { .pNext = has_resource ? &dedicated_info : nullptr,
+                                            .allocationSize = info.requirements.size,
+                                            .memoryTypeIndex = memory_type }) };
+
+    gpu_allocation result{ .memory = memory,
+                           .offset = 0,
+                           .size = info.requirements.size,
+                           .pool = gpu_allocator::impl::dedicated_pool };
+
+    if (is_host_visible(a, memory_type))
+    {
+        try
+        {
+            result.mapped = map(a, memory);
+        }
+        catch (...)
+        {
+            a.vk_device.freeMemory(memory, nullptr, *a.dispatcher);
+            throw;
+        }
+    }
+
+    std::scoped_lock const lock{ *a.mutex };
+
+    a.dedicated_bytes += result.size;
+    ++a.dedicated_count;
+
+    return result;
+}
+
+} // namespace
+
+gpu_allocator::gpu_allocator(device const& dev, vk::DeviceSize const block_size)
+{
+    auto const& dev_impl{ device::impl::from_device(dev) };
+
+    data->vk_device = *dev_impl.vk_device;
+    data->dispatcher = dev_impl.vk_device.getDispatcher();
+    data->memory_properties = dev_impl.vk_physical_device.getMemoryProperties();
+    data->buffer_image_granularity = dev_impl.vk_physical_device.getProperties().limits.bufferImageGranularity;
+    data->block_size = block_size;
+
+    data->pools.resize(std::size_t{ data->memory_properties.memoryTypeCount } * 2);
+    for (std::uint32_t i{ 0 }; i < data->pools.size(); ++i)
+    {
+        data->pools[i].memory_type = i / 2;
+    }
+}
+
+gpu_allocator::~gpu_allocator()
+{
+    for (auto const& pool : data->pools)
+    {
+        for (auto const& block : pool.blocks)
+        {
+            if (block)
+            {
+                // memory is implicitly unmapped
+                data->vk_device.freeMemory(block->memory, nullptr, *data->dispatcher);
+            }
+        }
+    }
+}
+
+gpu_allocator::gpu_allocator(gpu_allocator&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+gpu_allocator&
+gpu_allocator::operator=(gpu_allocator other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(gpu_allocator& l, gpu_allocator& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+gpu_allocation
+gpu_allocator::allocate(gpu_allocation_info const& info)
+try
+{
+    auto const& requirements{ info.requirements };
+    auto const memory_type{ find_memory_type(*data, requirements.memoryTypeBits, info.usage) };
+    auto const block_size{ block_size_of(*data, memory_type) };
+
+    if (info.dedicated || requirements.size > block_size / 2)
+    {
+        return allocate_dedicated(*data, info, memory_type);
+    }
+
+    bool const separate_optimal{ info.optimal_image && data->buffer_image_granularity > 1 };
+    auto const pool_index{ memory_type * 2 + (separate_optimal ? 1 : 0) };
+
+    std::scoped_lock const lock{ *data->mutex };
+
+    auto& blocks{ data->pools[pool_index].blocks };
+
+    for (std::uint32_t i{ 0 }; i < blocks.size(); ++i)
+    {
+        if (!blocks[i])
+        {
+            continue;
+        }
+
+        if (auto const r{ blocks[i]->ranges.allocate(requirements.size, requirements.alignment) })
+        {
+            return make_allocation(*blocks[i], *r, pool_index, i);
+        }
+    }
+
+    auto const free_slot{ std::ranges::find(blocks, nullptr) };
+    auto const block_index{ static_cast<std::uint32_t>(free_slot - begin(blocks)) };
+
+    auto block{ make_block(*data, memory_type, block_size) };
+    auto const r{ block->ranges.allocate(requirements.size, requirements.alignment) };
+    assert(r);
+
+    if (free_slot == end(blocks))
+    {
+        blocks.push_back(std::move(block));
+    } else
+    {
+        *free_slot = std::move(block);
+    }
+
+    return make_allocation(*blocks[block_index], *r, pool_index, block_index);
+}
+catch (gpu_allocator::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "gpu_allocator::allocate: Internal call to vulkan failed" });
+}
+
+void
+gpu_allocator::free(gpu_allocation const& a) noexcept
+{
+    if (!a)
+    {
+        return;
+    }
+
+    if (a.pool == impl::dedicated_pool)
+    {
+        data->vk_device.freeMemory(a.memory, nullptr, *data->dispatcher);
+
+        std::scoped_lock const lock{ *data->mutex };
+
+        data->dedicated_bytes -= a.size;
+        --data->dedicated_count;
+
+        return;
+    }
+
+    std::scoped_lock const lock{ *data->mutex };
+
+    auto& blocks{ data->pools[a.pool].blocks };
+    auto& block{ blocks[a.block] };
+
+    block->ranges.free({ .offset = a.offset, .size = a.size, .node = a.node });
+
+    // one empty block is kept, so allocating and freeing in a loop doesn't allocate device memory each time
+    auto const live_blocks{ std::ranges::count_if(blocks, [](auto const& b) { return b != nullptr; }) };
+    if (block->ranges.empty() && live_blocks > 1)
+    {
+        data->vk_device.freeMemory(block->memory, nullptr, *data->dispatcher);
+        block.reset();
+    }
+}
+
+gpu_allocator_stats
+gpu_allocator::stats() const
+{
+    std::scoped_lock const lock{ *data->mutex };
+
+    gpu_allocator_stats s{ .used_bytes = data->dedicated_bytes,
+                           .reserved_bytes = data->dedicated_bytes,
+                           .dedicated_count = data->dedicated_count,
+                           .allocation_count = data->dedicated_count };
+
+    std::uint64_t free_bytes{ 0 };
+    std::uint64_t largest_free_sum{ 0 };
+
+    for (auto const& pool : data->pools)
+    {
+        for (auto const& block : pool.blocks)
+        {
+            if (!block)
+            {
+                continue;
+            }
+
+            auto const& ranges{ block->ranges };
+            auto const largest{ ranges.largest_free() };
+
+            s.used_bytes += ranges.used();
+            s.reserved_bytes += ranges.capacity();
+            s.allocation_count += ranges.allocation_count();
+            ++s.block_count;
+            s.largest_free_range = std::max(s.largest_free_range, largest);
+
+            free_bytes += ranges.capacity() - ranges.used();
+            largest_free_sum += largest;
+        }
+    }
+
+    if (free_bytes > 0)
+    {
+        s.fragmentation = 1.0f - static_cast<float>(static_cast<double>(largest_free_sum) /
+                                                    static_cast<double>(free_bytes));
+    }
+
+    return s;
+}
+
+} // namespace orbi
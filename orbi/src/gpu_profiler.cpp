@@ -0,0 +1,248 @@
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/gpu_profiler.hpp>
+#include <orbi/renderer.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <numeric>
+#include <utility>
+
+namespace orbi
+{
+
+namespace
+{
+
+void
+add_sample(gpu_profiler::impl& p, std::string_view const name, double const ms)
+{
+    auto it{ p.scopes.find(name) };
+    if (it == end(p.scopes))
+    {
+        it = p.scopes.emplace(std::string{ name }, gpu_profiler::impl::history{}).first;
+        it->second.samples.reserve(p.history_length);
+    }
+
+    auto& h{ it->second };
+    if (h.samples.size() < p.history_length)
+    {
+        h.samples.push_back(ms);
+    } else
+    {
+        h.samples[h.next] = ms;
+    }
+
+    h.next = (h.next + 1) % p.history_length;
+}
+
+// reads results of previous use of `f`, gpu already finished it
+void
+collect(gpu_profiler::impl& p, gpu_profiler::impl::frame& f)
+{
+    if (!f.reset)
+    {
+        return;
+    }
+
+    auto const used{ f.used->load() };
+    p.dropped += used > p.max_scopes ? used - p.max_scopes : 0;
+
+    auto const count{ std::min(used, p.max_scopes) };
+    if (count == 0)
+    {
+        return;
+    }
+
+    // value and availability of each query
+    constexpr std::size_t values_per_query{ 2 };
+    constexpr auto stride{ values_per_query * sizeof(std::uint64_t) };
+
+    auto const [result, values] = f.query_pool.getResults<std::uint64_t>(
+        0, count * 2, std::size_t{ count } * 2 * stride, stride,
+        vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+
+    // scopes with the same name are summed
+    std::map<std::string_view, double> frame_ms;
+
+    for (std::uint32_t i{ 0 }; i < count; ++i)
+    {
+        auto const begin_index{ std::size_t{ i } * 2 * values_per_query };
+        auto const end_index{ begin_index + values_per_query };
+
+        bool const available{ values[begin_index + 1] != 0 && values[end_index + 1] != 0 };
+        if (!available)
+        {
+            // e.g. command buffer with scope wasn't submitted
+            continue;
+        }
+
+        auto const ticks{ (values[end_index] - values[begin_index]) & p.timestamp_mask };
+        frame_ms[f.names[i]] += static_cast<double>(ticks) * p.ns_per_tick / 1e6;
+    }
+
+    for (auto const& [name, ms] : frame_ms)
+    {
+        add_sample(p, name, ms);
+    }
+}
+
+} // namespace
+
+gpu_profiler::gpu_profiler(device const& dev, frame_index_type const frames_in_flight,
+                           std::uint32_t const max_scopes_per_frame, std::uint32_t const history_length)
+try
+{
+    assert(frames_in_flight > 0);
+    assert(max_scopes_per_frame > 0);
+    assert(history_length > 0);
+
+    auto const& dev_impl{ device::impl::from_device(dev) };
+    auto const& pd{ dev_impl.vk_physical_device };
+
+    auto const valid_bits{ pd.getQueueFamilyProperties()[dev_impl.graphics_queue.family_index].timestampValidBits };
+
+    data->enabled = valid_bits > 0;
+    data->timestamp_mask = valid_bits >= 64 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << valid_bits) - 1;
+    data->ns_per_tick = pd.getProperties().limits.timestampPeriod;
+    data->max_scopes = max_scopes_per_frame;
+    data->history_length = history_length;
+
+    if (!data->enabled)
+    {
+        return;
+    }
+
+    data->frames.resize(frames_in_flight);
+    for (auto& f : data->frames)
+    {
+        f.query_pool = vk::raii::QueryPool{ dev_impl.vk_device,
+                                            vk::QueryPoolCreateInfo{ .queryType = vk::QueryType::eTimestamp,
+                                                                     .queryCount = max_scopes_per_frame * 2 } };
+        f.names.resize(max_scopes_per_frame);
+    }
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "gpu_profiler::gpu_profiler: Internal call to vulkan failed" });
+}
+
+gpu_profiler::~gpu_profiler() = default;
+
+gpu_profiler::gpu_profiler(gpu_profiler&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+gpu_profiler&
+gpu_profiler::operator=(gpu_profiler other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(gpu_profiler& l, gpu_profiler& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+void
+gpu_profiler::begin_frame(renderer const& r, vk::raii::CommandBuffer const& command_buffer)
+try
+{
+    data->current_frame = r.current_frame();
+
+    if (!data->enabled)
+    {
+        return;
+    }
+
+    auto& f{ data->frames.at(data->current_frame) };
+
+    collect(*data, f);
+
+    command_buffer.resetQueryPool(f.query_pool, 0, data->max_scopes * 2);
+    f.used->store(0);
+    f.reset = true;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "gpu_profiler::begin_frame: Internal call to vulkan failed" });
+}
+
+std::vector<gpu_scope_stats>
+gpu_profiler::stats() const
+{
+    std::vector<gpu_scope_stats> result;
+    result.reserve(data->scopes.size());
+
+    for (auto const& [name, h] : data->scopes)
+    {
+        auto const [min, max] = std::ranges::minmax(h.samples);
+        auto const sum{ std::accumulate(begin(h.samples), end(h.samples), 0.0) };
+
+        result.push_back({ .name = name,
+                           .min_ms = min,
+                           .avg_ms = sum / static_cast<double>(h.samples.size()),
+                           .max_ms = max,
+                           .sample_count = static_cast<std::uint32_t>(h.samples.size()) });
+    }
+
+    return result;
+}
+
+std::uint64_t
+gpu_profiler::dropped_scopes() const noexcept
+{
+    return data->dropped;
+}
+
+gpu_scope::gpu_scope(gpu_profiler& owner, vk::raii::CommandBuffer const& cmd, std::string_view const name)
+    : profiler{ &owner }
+    , command_buffer{ &cmd }
+{
+    auto& p{ gpu_profiler::impl::from_profiler(owner) };
+    if (!p.enabled)
+    {
+        return;
+    }
+
+    frame = p.current_frame;
+    auto& f{ p.frames[frame] };
+
+    query = f.used->fetch_add(1, std::memory_order_relaxed);
+    if (query >= p.max_scopes)
+    {
+        return;
+    }
+
+    // each scope has its own slot, so concurrent scopes don't race
+    f.names[query] = name;
+    active = true;
+
+    // with synchronization2 `eNone` is written as soon as previous commands are started
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eNone, f.query_pool, query * 2);
+}
+
+gpu_scope::~gpu_scope()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    auto const& p{ gpu_profiler::impl::from_profiler(*profiler) };
+
+    // written once all commands of scope are finished
+    command_buffer->writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, p.frames[frame].query_pool,
+                                    query * 2 + 1);
+}
+
+} // namespace orbi
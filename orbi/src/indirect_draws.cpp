@@ -0,0 +1,280 @@
+#include <orbi/deletion_queue.hpp>
+#include <orbi/descriptor_heap.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/gpu_allocator.hpp>
+#include <orbi/indirect_draws.hpp>
+#include <orbi/pipeline_cache.hpp>
+#include <orbi/renderer.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// generated by `orbi_target_shaders`, defines `detail::builtin_shaders`
+#include <shaders/builtin.hpp>
+
+namespace orbi
+{
+
+namespace
+{
+
+// layout matches push constants of `shaders/cull.comp`
+struct cull_constants
+{
+    std::array<std::array<float, 4>, 6> planes;
+    std::uint32_t object_count;
+    std::uint32_t objects;
+    std::uint32_t draws;
+};
+
+static_assert(sizeof(cull_constants) <= descriptor_heap::push_constant_size);
+
+struct retired_storage
+{
+    std::optional<indirect_draws::impl::storage> objects;
+    std::vector<indirect_draws::impl::storage> draws;
+    vk::raii::Pipeline pipeline;
+};
+
+indirect_draws::impl::storage
+make_storage(device::impl const& dev, vk::DeviceSize const size, vk::BufferUsageFlags const usage)
+{
+    indirect_draws::impl::storage s{ *dev.allocator, *dev.descriptors };
+
+    s.buffer = vk::raii::Buffer{ dev.vk_device,
+                                 vk::BufferCreateInfo{ .size = size,
+                                                       .usage = usage | vk::BufferUsageFlagBits::eStorageBuffer } };
+
+    s.allocation = s.allocator->allocate({ .requirements = s.buffer.getMemoryRequirements() });
+    s.buffer.bindMemory(s.allocation.memory, s.allocation.offset);
+    s.handle = s.descriptors->add(*s.buffer);
+
+    return s;
+}
+
+void
+barrier(vk::raii::CommandBuffer const& command_buffer, vk::PipelineStageFlags2 const src_stage,
+        vk::AccessFlags2 const src_access, vk::PipelineStageFlags2 const dst_stage, vk::AccessFlags2 const dst_access)
+{
+    vk::MemoryBarrier2 const memory_barrier{ .srcStageMask = src_stage,
+                                             .srcAccessMask = src_access,
+                                             .dstStageMask = dst_stage,
+                                             .dstAccessMask = dst_access };
+
+    command_buffer.pipelineBarrier2({ .memoryBarrierCount = 1, .pMemoryBarriers = &memory_barrier });
+}
+
+} // namespace
+
+frustum
+make_frustum(std::array<float, 16> const& m) noexcept
+{
+    // Gribb-Hartmann: planes are sums and differences of rows of the matrix
+    auto const row = [&](std::size_t const i) { return std::array{ m[i], m[4 + i], m[8 + i], m[12 + i] }; };
+
+    auto const combine = [](std::array<float, 4> const& a, std::array<float, 4> const& b, float const sign)
+    {
+        std::array<float, 4> p{ a[0] + sign * b[0], a[1] + sign * b[1], a[2] + sign * b[2], a[3] + sign * b[3] };
+
+        // normalized, so distance to plane is comparable with radius of sphere
+        auto const length{ std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]) };
+        if (length > 0)
+        {
+            std::ranges::for_each(p, [&](float& v) { v /= length; });
+        }
+
+        return p;
+    };
+
+    auto const x{ row(0) };
+    auto const y{ row(1) };
+    auto const z{ row(2) };
+    auto const w{ row(3) };
+
+    // vulkan clip space has `0 <= z <= w`, so near plane is `z` row alone
+    return { .planes = { combine(w, x, 1), combine(w, x, -1), combine(w, y, 1), combine(w, y, -1),
+                         combine(z, {}, 0), combine(w, z, -1) } };
+}
+
+indirect_draws::indirect_draws(device const& dev, frame_index_type const frames_in_flight,
+                               std::uint32_t const max_objects)
+try
+{
+    assert(dev.bindless());
+    assert(dev.indirect_draw());
+    assert(frames_in_flight > 0);
+    assert(max_objects > 0);
+
+    auto const& dev_impl{ device::impl::from_device(dev) };
+    auto const& vk_device{ dev_impl.vk_device };
+
+    data->descriptors = dev_impl.descriptors.get();
+    data->deletion = dev_impl.deletion.get();
+    data->max_objects = max_objects;
+
+    data->objects.emplace(make_storage(dev_impl, std::uint64_t{ max_objects } * sizeof(draw_object),
+                                       vk::BufferUsageFlagBits::eTransferDst));
+    dev_impl.set_name(*data->objects->buffer, "orbi::indirect_draws objects");
+
+    data->draws.reserve(frames_in_flight);
+    for (frame_index_type i{ 0 }; i < frames_in_flight; ++i)
+    {
+        // transfer source, so draws can be copied out for inspection
+        data->draws.push_back(make_storage(
+            dev_impl, impl::count_size + std::uint64_t{ max_objects } * sizeof(vk::DrawIndexedIndirectCommand),
+            vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst |
+                vk::BufferUsageFlagBits::eTransferSrc));
+        dev_impl.set_name(*data->draws.back().buffer, "orbi::indirect_draws draws of frame {}", i);
+    }
+
+    constexpr auto cull_code{ detail::builtin_shaders.at("cull.comp") };
+    vk::raii::ShaderModule const shader{ vk_device,
+                                         vk::ShaderModuleCreateInfo{ .codeSize = cull_code.size_bytes(),
+                                                                     .pCode = cull_code.data() } };
+
+    data->pipeline = vk::raii::Pipeline{
+        vk_device, pipeline_cache::impl::from_pipeline_cache(dev.cache()).vk_pipeline_cache,
+        vk::ComputePipelineCreateInfo{
+            .stage = { .stage = vk::ShaderStageFlagBits::eCompute, .module = shader, .pName = "main" },
+            .layout = data->descriptors->pipeline_layout() }
+    };
+    dev_impl.set_name(*data->pipeline, "orbi::indirect_draws cull");
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "indirect_draws::indirect_draws: Internal call to vulkan failed" });
+}
+
+indirect_draws::~indirect_draws()
+{
+    // moved-from or never culled
+    if (!data->frames)
+    {
+        return;
+    }
+
+    // frames in flight may still cull with buffers or draw from them
+    auto const value{ data->frames->next.load(std::memory_order_relaxed) };
+    auto retired{ std::make_shared<retired_storage>(retired_storage{ .objects = std::move(data->objects),
+                                                                     .draws = std::move(data->draws),
+                                                                     .pipeline = std::move(data->pipeline) }) };
+    deletion_queue::impl::push(*data->deletion, std::move(data->frames), value, std::move(retired));
+}
+
+indirect_draws::indirect_draws(indirect_draws&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+indirect_draws&
+indirect_draws::operator=(indirect_draws other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(indirect_draws& l, indirect_draws& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+void
+indirect_draws::update(vk::raii::CommandBuffer const& command_buffer, std::uint32_t const first,
+                       std::span<draw_object const> const objects) const
+{
+    assert(std::uint64_t{ first } + objects.size() <= data->max_objects);
+
+    if (objects.empty())
+    {
+        return;
+    }
+
+    // culling and draws of earlier frames may still read objects
+    barrier(command_buffer,
+            vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eDrawIndirect |
+                vk::PipelineStageFlagBits2::eVertexShader,
+            {}, vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite);
+
+    // `vkCmdUpdateBuffer` copies at most 65536 bytes
+    constexpr std::size_t max_chunk{ 65536 / sizeof(draw_object) };
+
+    for (std::size_t offset{ 0 }; offset < objects.size(); offset += max_chunk)
+    {
+        auto const chunk{ objects.subspan(offset, std::min(max_chunk, objects.size() - offset)) };
+
+        command_buffer.updateBuffer<draw_object>(data->objects->buffer, (first + offset) * sizeof(draw_object),
+                                                 { static_cast<std::uint32_t>(chunk.size()), chunk.data() });
+    }
+
+    barrier(command_buffer, vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite,
+            vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eVertexShader,
+            vk::AccessFlagBits2::eShaderStorageRead);
+}
+
+void
+indirect_draws::cull(renderer const& r, vk::raii::CommandBuffer const& command_buffer, frustum const& f,
+                     std::uint32_t const count)
+{
+    assert(count <= data->max_objects);
+
+    data->current_frame = r.current_frame();
+    data->frames = timeline::impl::from_timeline(r.frame_timeline()).shared;
+    auto const& draws{ data->draws.at(data->current_frame) };
+
+    // previous use of draws of this frame is finished, `renderer::begin_frame` waited for it
+    command_buffer.fillBuffer(draws.buffer, 0, sizeof(std::uint32_t), 0);
+
+    barrier(command_buffer, vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite,
+            vk::PipelineStageFlagBits2::eComputeShader,
+            vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+
+    cull_constants const constants{ .planes = f.planes,
+                                    .object_count = count,
+                                    .objects = data->objects->handle.index,
+                                    .draws = draws.handle.index };
+
+    command_buffer.bindPipeline(vk::PipelineBindPoint::eCompute, data->pipeline);
+    data->descriptors->bind(command_buffer, vk::PipelineBindPoint::eCompute);
+    command_buffer.pushConstants<cull_constants>(data->descriptors->pipeline_layout(), vk::ShaderStageFlagBits::eAll,
+                                                 0, constants);
+    command_buffer.dispatch((count + workgroup_size - 1) / workgroup_size, 1, 1);
+
+    barrier(command_buffer, vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
+            vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead);
+}
+
+void
+indirect_draws::draw(vk::raii::CommandBuffer const& command_buffer) const
+{
+    auto const& draws{ data->draws.at(data->current_frame) };
+
+    command_buffer.drawIndexedIndirectCount(draws.buffer, impl::count_size, draws.buffer, 0, data->max_objects,
+                                            sizeof(vk::DrawIndexedIndirectCommand));
+}
+
+std::uint32_t
+indirect_draws::max_objects() const noexcept
+{
+    return data->max_objects;
+}
+
+storage_buffer_handle
+indirect_draws::objects() const noexcept
+{
+    return data->objects->handle;
+}
+
+} // namespace orbi
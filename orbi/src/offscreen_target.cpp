@@ -0,0 +1,352 @@
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/external.hpp>
+#include <orbi/gpu_allocator.hpp>
+#include <orbi/offscreen_target.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cassert>
+#include <optional>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace orbi
+{
+
+namespace
+{
+
+constexpr auto external_handle_type{ vk::ExternalMemoryHandleTypeFlagBits::eOpaqueFd };
+
+// closes file descriptor on destruction, unless it was handed over to vulkan
+struct owned_fd
+{
+    explicit owned_fd(int const f) noexcept
+        : fd{ f }
+    {
+    }
+
+    ~owned_fd()
+    {
+        if (fd < 0)
+        {
+            return;
+        }
+
+#ifdef _WIN32
+        ::_close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+
+    owned_fd(owned_fd const&) = delete;
+    owned_fd& operator=(owned_fd const&) = delete;
+
+    int fd;
+};
+
+// the same for exporter and importer, image parameters of both must match
+void
+create_image(offscreen_target::impl& t, vk::raii::Device const& vk_device, bool const external)
+{
+    vk::ExternalMemoryImageCreateInfo const external_info{ .handleTypes = external_handle_type };
+
+    t.image = vk::raii::Image{
+        vk_device, vk::ImageCreateInfo{ .pNext = external ? &external_info : nullptr,
+                                        .imageType = vk::ImageType::e2D,
+                                        .format = t.format,
+                                        .extent = { t.extent.width, t.extent.height, 1 },
+                                        .mipLevels = 1,
+                                        .arrayLayers = 1,
+                                        .samples = vk::SampleCountFlagBits::e1,
+                                        .tiling = vk::ImageTiling::eOptimal,
+                                        .usage = vk::ImageUsageFlagBits::eColorAttachment |
+                                                 vk::ImageUsageFlagBits::eTransferSrc |
+                                                 vk::ImageUsageFlagBits::eSampled,
+                                        .sharingMode = vk::SharingMode::eExclusive,
+                                        .initialLayout = vk::ImageLayout::eUndefined }
+    };
+}
+
+void
+create_view(offscreen_target::impl& t, vk::raii::Device const& vk_device)
+{
+    vk::ImageSubresourceRange const range{ .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                           .baseMipLevel = 0,
+                                           .levelCount = 1,
+                                           .baseArrayLayer = 0,
+                                           .layerCount = 1 };
+
+    t.view = vk::raii::ImageView{ vk_device, vk::ImageViewCreateInfo{ .image = t.image,
+                                                                      .viewType = vk::ImageViewType::e2D,
+                                                                      .format = t.format,
+                                                                      .subresourceRange = range } };
+
+    t.dev->set_name(*t.image, "orbi::offscreen_target {}x{}", t.extent.width, t.extent.height);
+    t.dev->set_name(*t.view, "orbi::offscreen_target {}x{} view", t.extent.width, t.extent.height);
+}
+
+void
+allocate(offscreen_target::impl& t, vk::raii::Device const& vk_device)
+{
+    auto const requirements{
+        vk_device.getImageMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(
+            { .image = t.image })
+    };
+    bool const dedicated{ requirements.get<vk::MemoryDedicatedRequirements>().prefersDedicatedAllocation ==
+                          vk::True };
+
+    t.allocation = t.dev->allocator->allocate(
+        { .requirements = requirements.get<vk::MemoryRequirements2>().memoryRequirements,
+          .usage = memory_usage::gpu_only,
+          .optimal_image = true,
+          .dedicated = dedicated,
+          .dedicated_image = dedicated ? *t.image : vk::Image{} });
+
+    // memory isn't owned by raii member, so it is freed by hand if image can't be completed
+    try
+    {
+        t.image.bindMemory(t.allocation.memory, t.allocation.offset);
+        create_view(t, vk_device);
+    }
+    catch (...)
+    {
+        t.dev->allocator->free(t.allocation);
+        throw;
+    }
+}
+
+/*
+    exported memory is whole `VkDeviceMemory`, so it isn't sub-allocated by `gpu_allocator`,
+    dedicated allocation is required by some drivers for external images anyway
+*/
+void
+allocate_exportable(offscreen_target::impl& t, device::impl const& dev)
+{
+    auto const requirements{ t.image.getMemoryRequirements() };
+    auto const memory_properties{ dev.vk_physical_device.getMemoryProperties() };
+
+    // device local if possible
+    std::optional<std::uint32_t> memory_type;
+    for (std::uint32_t i{ 0 }; i < memory_properties.memoryTypeCount; ++i)
+    {
+        if (!(requirements.memoryTypeBits & (1u << i)))
+        {
+            continue;
+        }
+
+        if (!memory_type)
+        {
+            memory_type = i;
+        }
+
+        if (memory_properties.memoryTypes[i].propertyFlags & vk::MemoryPropertyFlagBits::eDeviceLocal)
+        {
+            memory_type = i;
+            break;
+        }
+    }
+
+    if (!memory_type)
+    {
+        throw offscreen_target::error{ "offscreen_target: there is no memory type for exportable image" };
+    }
+
+    vk::MemoryDedicatedAllocateInfo const dedicated_info{ .image = t.image };
+    vk::ExportMemoryAllocateInfo const export_info{ .pNext = &dedicated_info, .handleTypes = external_handle_type };
+
+    t.memory_size = requirements.size;
+    t.memory_type_index = *memory_type;
+    t.memory = vk::raii::DeviceMemory{ dev.vk_device,
+                                       vk::MemoryAllocateInfo{ .pNext = &export_info,
+                                                               .allocationSize = t.memory_size,
+                                                               .memoryTypeIndex = t.memory_type_index } };
+
+    t.image.bindMemory(t.memory, 0);
+    create_view(t, dev.vk_device);
+}
+
+std::pair<device_uuid, device_uuid>
+uuids(vk::raii::PhysicalDevice const& pd)
+{
+    auto const properties{ pd.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>()
+                               .get<vk::PhysicalDeviceIDProperties>() };
+
+    return { properties.deviceUUID, properties.driverUUID };
+}
+
+} // namespace
+
+offscreen_target::offscreen_target(device const& dev, vk::Extent2D const extent, vk::Format const format,
+                                   bool const exportable)
+try
+{
+    assert(extent.width > 0 && extent.height > 0);
+    assert(!exportable || dev.external_memory());
+
+    auto const& dev_impl{ device::impl::from_device(dev) };
+
+    data->dev = &dev_impl;
+    data->extent = extent;
+    data->format = format;
+
+    create_image(*data, dev_impl.vk_device, exportable);
+
+    if (exportable)
+    {
+        allocate_exportable(*data, dev_impl);
+    } else
+    {
+        allocate(*data, dev_impl.vk_device);
+    }
+}
+catch (offscreen_target::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "offscreen_target::offscreen_target: Internal call to vulkan failed" });
+}
+
+offscreen_target::~offscreen_target()
+{
+    // moved-from target owns nothing
+    if (!*data->image)
+    {
+        return;
+    }
+
+    data->view = nullptr;
+    data->image = nullptr;
+    data->dev->allocator->free(data->allocation);
+}
+
+offscreen_target::offscreen_target(offscreen_target&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+offscreen_target&
+offscreen_target::operator=(offscreen_target other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(offscreen_target& l, offscreen_target& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+vk::Image
+offscreen_target::image() const noexcept
+{
+    return data->image;
+}
+
+vk::ImageView
+offscreen_target::view() const noexcept
+{
+    return data->view;
+}
+
+vk::Extent2D
+offscreen_target::extent() const noexcept
+{
+    return data->extent;
+}
+
+vk::Format
+offscreen_target::format() const noexcept
+{
+    return data->format;
+}
+
+external_image
+offscreen_target::export_image() const
+try
+{
+    assert(*data->memory);
+
+    auto const [physical_device_uuid, driver_uuid] = uuids(data->dev->vk_physical_device);
+
+    return { .memory_fd = data->dev->vk_device.getMemoryFdKHR({ .memory = data->memory,
+                                                                 .handleType = external_handle_type }),
+             .memory_size = data->memory_size,
+             .memory_type_index = data->memory_type_index,
+             .extent = data->extent,
+             .format = data->format,
+             .physical_device_uuid = physical_device_uuid,
+             .driver_uuid = driver_uuid };
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "offscreen_target::export_image: Internal call to vulkan failed" });
+}
+
+offscreen_target
+offscreen_target::import_image(device const& dev, external_image const& image)
+try
+{
+    assert(dev.external_memory());
+
+    owned_fd memory_fd{ image.memory_fd };
+
+    auto const& dev_impl{ device::impl::from_device(dev) };
+
+    if (uuids(dev_impl.vk_physical_device) != std::pair{ image.physical_device_uuid, image.driver_uuid })
+    {
+        throw error{ "offscreen_target::import_image: image was exported by other device or driver" };
+    }
+
+    offscreen_target target;
+    auto& t{ *target.data };
+
+    t.dev = &dev_impl;
+    t.extent = image.extent;
+    t.format = image.format;
+    t.memory_size = image.memory_size;
+    t.memory_type_index = image.memory_type_index;
+
+    create_image(t, dev_impl.vk_device, true);
+
+    vk::MemoryDedicatedAllocateInfo const dedicated_info{ .image = t.image };
+    vk::ImportMemoryFdInfoKHR const import_info{ .pNext = &dedicated_info,
+                                                 .handleType = external_handle_type,
+                                                 .fd = memory_fd.fd };
+
+    t.memory = vk::raii::DeviceMemory{ dev_impl.vk_device,
+                                       vk::MemoryAllocateInfo{ .pNext = &import_info,
+                                                               .allocationSize = t.memory_size,
+                                                               .memoryTypeIndex = t.memory_type_index } };
+
+    // vulkan owns `memory_fd` once import succeeded, it's closed together with `t.memory`
+    memory_fd.fd = -1;
+
+    t.image.bindMemory(t.memory, 0);
+    create_view(t, dev_impl.vk_device);
+
+    return target;
+}
+catch (offscreen_target::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "offscreen_target::import_image: Internal call to vulkan failed" });
+}
+
+} // namespace orbi
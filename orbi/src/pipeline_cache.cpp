@@ -0,0 +1,269 @@
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/pipeline_cache.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <random>
+#include <span>
+#include <utility>
+
+namespace orbi
+{
+
+namespace
+{
+
+constexpr std::array<char, 4> file_magic{ 'O', 'R', 'B', 'I' };
+constexpr std::uint32_t file_version{ 1 };
+
+/*
+    prepended to data of `VkPipelineCache`,
+    driver version isn't a part of vulkan header, but cache of other driver version is useless
+*/
+struct file_header
+{
+    std::array<char, 4> magic{};
+    std::uint32_t version{ 0 };
+    std::uint32_t vendor_id{ 0 };
+    std::uint32_t device_id{ 0 };
+    std::uint32_t driver_version{ 0 };
+    device_uuid pipeline_cache_uuid{};
+    std::uint32_t reserved{ 0 };
+    std::uint64_t data_size{ 0 };
+    std::uint64_t data_hash{ 0 };
+};
+
+// it is written as is, so it must have no padding
+static_assert(sizeof(file_header) == 56);
+static_assert(std::is_trivially_copyable_v<file_header>);
+
+// FNV-1a, corrupted cache may crash some drivers, so it is checked before use
+std::uint64_t
+hash(std::span<std::byte const> const bytes)
+{
+    std::uint64_t h{ 0xcbf29ce484222325 };
+    for (auto const b : bytes)
+    {
+        h = (h ^ static_cast<std::uint64_t>(b)) * 0x100000001b3;
+    }
+
+    return h;
+}
+
+std::vector<std::byte>
+read_file(std::filesystem::path const& path)
+{
+    std::error_code ec;
+    auto const size{ std::filesystem::file_size(path, ec) };
+    if (ec)
+    {
+        return {};
+    }
+
+    std::vector<std::byte> bytes(size);
+
+    std::ifstream file{ path, std::ios::binary };
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(size)))
+    {
+        return {};
+    }
+
+    return bytes;
+}
+
+/*
+    @return data for `VkPipelineCacheCreateInfo` or empty span if file doesn't match `expected` header
+*/
+std::span<std::byte const>
+validate(std::span<std::byte const> const file, file_header const& expected)
+{
+    file_header header;
+    if (file.size() < sizeof header)
+    {
+        return {};
+    }
+
+    std::memcpy(&header, file.data(), sizeof header);
+    auto const payload{ file.subspan(sizeof header) };
+
+    bool const header_matches{ header.magic == expected.magic && header.version == expected.version &&
+                               header.vendor_id == expected.vendor_id &&
+                               header.device_id == expected.device_id &&
+                               header.driver_version == expected.driver_version &&
+                               header.pipeline_cache_uuid == expected.pipeline_cache_uuid };
+
+    if (!header_matches || header.data_size != payload.size() || header.data_hash != hash(payload))
+    {
+        return {};
+    }
+
+    // header written by driver itself
+    VkPipelineCacheHeaderVersionOne vk_header{};
+    if (payload.size() < sizeof vk_header)
+    {
+        return {};
+    }
+
+    std::memcpy(&vk_header, payload.data(), sizeof vk_header);
+
+    bool const vk_header_matches{ vk_header.headerSize >= sizeof vk_header &&
+                                  vk_header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                                  vk_header.vendorID == expected.vendor_id &&
+                                  vk_header.deviceID == expected.device_id &&
+                                  std::memcmp(vk_header.pipelineCacheUUID, expected.pipeline_cache_uuid.data(),
+                                              VK_UUID_SIZE) == 0 };
+
+    return vk_header_matches ? payload : std::span<std::byte const>{};
+}
+
+file_header
+make_header(vk::PhysicalDeviceProperties const& properties)
+{
+    return { .magic = file_magic,
+             .version = file_version,
+             .vendor_id = properties.vendorID,
+             .device_id = properties.deviceID,
+             .driver_version = properties.driverVersion,
+             .pipeline_cache_uuid = properties.pipelineCacheUUID };
+}
+
+} // namespace
+
+pipeline_cache::pipeline_cache(device const& dev, std::filesystem::path const& directory)
+try
+{
+    auto const& dev_impl{ device::impl::from_device(dev) };
+    auto const properties{ dev_impl.vk_physical_device.getProperties() };
+    auto const header{ make_header(properties) };
+
+    data->vendor_id = header.vendor_id;
+    data->device_id = header.device_id;
+    data->driver_version = header.driver_version;
+    data->pipeline_cache_uuid = header.pipeline_cache_uuid;
+
+    std::vector<std::byte> file;
+    if (!directory.empty())
+    {
+        std::string uuid;
+        for (auto const byte : header.pipeline_cache_uuid)
+        {
+            uuid += std::format("{:02x}", byte);
+        }
+
+        data->path = directory / std::format("{:08x}-{:08x}-{:08x}-{}.bin", header.vendor_id, header.device_id,
+                                             header.driver_version, uuid);
+        file = read_file(data->path);
+    }
+
+    auto const initial_data{ validate(file, header) };
+
+    data->vk_pipeline_cache = vk::raii::PipelineCache{
+        dev_impl.vk_device,
+        vk::PipelineCacheCreateInfo{ .initialDataSize = initial_data.size(), .pInitialData = initial_data.data() }
+    };
+
+    data->warm = !initial_data.empty();
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "pipeline_cache::pipeline_cache: Internal call to vulkan failed" });
+}
+
+pipeline_cache::~pipeline_cache()
+{
+    try
+    {
+        save();
+    }
+    catch (...)
+    {
+        // nothing can be done, next launch just starts with cold cache
+    }
+}
+
+pipeline_cache::pipeline_cache(pipeline_cache&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+pipeline_cache&
+pipeline_cache::operator=(pipeline_cache other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(pipeline_cache& l, pipeline_cache& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+void
+pipeline_cache::save() const
+try
+{
+    if (data->path.empty() || !*data->vk_pipeline_cache)
+    {
+        return;
+    }
+
+    auto const blob{ data->vk_pipeline_cache.getData() };
+    auto const payload{ std::as_bytes(std::span{ blob }) };
+
+    file_header header{ .magic = file_magic,
+                        .version = file_version,
+                        .vendor_id = data->vendor_id,
+                        .device_id = data->device_id,
+                        .driver_version = data->driver_version,
+                        .pipeline_cache_uuid = data->pipeline_cache_uuid };
+    header.data_size = payload.size();
+    header.data_hash = hash(payload);
+
+    std::filesystem::create_directories(data->path.parent_path());
+
+    // unique name, so concurrently running processes don't write the same temporary file
+    auto temporary{ data->path };
+    temporary += std::format(".{:08x}.tmp", std::random_device{}());
+
+    try
+    {
+        {
+            std::ofstream file{ temporary, std::ios::binary | std::ios::trunc };
+            file.exceptions(std::ofstream::badbit | std::ofstream::failbit);
+
+            file.write(reinterpret_cast<char const*>(&header), sizeof header);
+            file.write(reinterpret_cast<char const*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        }
+
+        // readers see either old or new file, never partially written one
+        std::filesystem::rename(temporary, data->path);
+    }
+    catch (...)
+    {
+        // e.g. disk is full, so partially written file isn't left behind
+        std::error_code ec;
+        std::filesystem::remove(temporary, ec);
+
+        throw;
+    }
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "pipeline_cache::save: failed to write '{}'", data->path.string() });
+}
+
+bool
+pipeline_cache::warm() const noexcept
+{
+    return data->warm;
+}
+
+} // namespace orbi
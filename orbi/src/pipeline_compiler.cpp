@@ -0,0 +1,330 @@
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/pipeline_cache.hpp>
+#include <orbi/pipeline_compiler.hpp>
+#include <orbi/trace.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <cassert>
+#include <mutex>
+#include <utility>
+
+namespace orbi
+{
+
+namespace
+{
+
+// parts of `pipeline_compiler::impl`, which stay valid even if it's moved
+struct compile_context
+{
+    vk::Device vk_device{};
+    vk::raii::detail::DeviceDispatcher const* dispatcher{ nullptr };
+    vk::PipelineCache vk_pipeline_cache{};
+};
+
+// destroyed right after pipeline creation, pipeline doesn't need it anymore
+struct shader_module
+{
+    shader_module(compile_context const& c, shader_stage_description const& stage)
+        : vk_device{ c.vk_device }
+        , dispatcher{ c.dispatcher }
+        , vk_module{ c.vk_device.createShaderModule(
+              { .codeSize = stage.code.size() * sizeof(std::uint32_t), .pCode = stage.code.data() }, nullptr,
+              *c.dispatcher) }
+    {
+    }
+
+    ~shader_module()
+    {
+        vk_device.destroyShaderModule(vk_module, nullptr, *dispatcher);
+    }
+
+    shader_module(shader_module const&) = delete;
+    shader_module& operator=(shader_module const&) = delete;
+
+    vk::Device vk_device;
+    vk::raii::detail::DeviceDispatcher const* dispatcher;
+    vk::ShaderModule vk_module;
+};
+
+vk::Pipeline
+create(compile_context const& c, graphics_pipeline_description const& d)
+{
+    shader_module const vertex{ c, d.vertex };
+    shader_module const fragment{ c, d.fragment };
+
+    std::array const stages{
+        vk::PipelineShaderStageCreateInfo{ .stage = vk::ShaderStageFlagBits::eVertex,
+                                           .module = vertex.vk_module,
+                                           .pName = d.vertex.entry_point.c_str() },
+        vk::PipelineShaderStageCreateInfo{ .stage = vk::ShaderStageFlagBits::eFragment,
+                                           .module = fragment.vk_module,
+                                           .pName = d.fragment.entry_point.c_str() },
+    };
+
+    vk::PipelineVertexInputStateCreateInfo const vertex_input{
+        .vertexBindingDescriptionCount = static_cast<std::uint32_t>(d.vertex_bindings.size()),
+        .pVertexBindingDescriptions = d.vertex_bindings.data(),
+        .vertexAttributeDescriptionCount = static_cast<std::uint32_t>(d.vertex_attributes.size()),
+        .pVertexAttributeDescriptions = d.vertex_attributes.data()
+    };
+
+    vk::PipelineInputAssemblyStateCreateInfo const input_assembly{ .topology = d.topology };
+
+    vk::PipelineViewportStateCreateInfo const viewport{ .viewportCount = 1, .scissorCount = 1 };
+
+    vk::PipelineRasterizationStateCreateInfo const rasterization{ .depthClampEnable = vk::False,
+                                                                  .rasterizerDiscardEnable = vk::False,
+                                                                  .polygonMode = d.polygon_mode,
+                                                                  .cullMode = d.cull_mode,
+                                                                  .frontFace = d.front_face,
+                                                                  .depthBiasEnable = vk::False,
+                                                                  .lineWidth = 1 };
+
+    vk::PipelineMultisampleStateCreateInfo const multisample{ .rasterizationSamples = vk::SampleCountFlagBits::e1,
+                                                              .sampleShadingEnable = vk::False,
+                                                              .minSampleShading = 1 };
+
+    vk::PipelineColorBlendStateCreateInfo const color_blend{
+        .logicOpEnable = vk::False,
+        .logicOp = vk::LogicOp::eCopy,
+        .attachmentCount = static_cast<std::uint32_t>(d.color_blend_attachments.size()),
+        .pAttachments = d.color_blend_attachments.data()
+    };
+
+    std::array const dynamic_states{ vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+    vk::PipelineDynamicStateCreateInfo const dynamic_state{ .dynamicStateCount = dynamic_states.size(),
+                                                            .pDynamicStates = dynamic_states.data() };
+
+    assert(d.color_formats.size() == d.color_blend_attachments.size());
+
+    bool const has_depth{ d.depth_format != vk::Format::eUndefined };
+    vk::PipelineDepthStencilStateCreateInfo const depth_stencil{ .depthTestEnable = vk::True,
+                                                                 .depthWriteEnable = vk::True,
+                                                                 .depthCompareOp = vk::CompareOp::eLess };
+
+    vk::PipelineRenderingCreateInfo const rendering{
+        .colorAttachmentCount = static_cast<std::uint32_t>(d.color_formats.size()),
+        .pColorAttachmentFormats = d.color_formats.data(),
+        .depthAttachmentFormat = d.depth_format
+    };
+
+    return c.vk_device
+        .createGraphicsPipeline(c.vk_pipeline_cache,
+                                { .pNext = &rendering,
+                                  .stageCount = stages.size(),
+                                  .pStages = stages.data(),
+                                  .pVertexInputState = &vertex_input,
+                                  .pInputAssemblyState = &input_assembly,
+                                  .pViewportState = &viewport,
+                                  .pRasterizationState = &rasterization,
+                                  .pMultisampleState = &multisample,
+                                  .pDepthStencilState = has_depth ? &depth_stencil : nullptr,
+                                  .pColorBlendState = &color_blend,
+                                  .pDynamicState = &dynamic_state,
+                                  .layout = d.layout },
+                                nullptr, *c.dispatcher)
+        .value;
+}
+
+vk::Pipeline
+create(compile_context const& c, compute_pipeline_description const& d)
+{
+    shader_module const shader{ c, d.shader };
+
+    return c.vk_device
+        .createComputePipeline(c.vk_pipeline_cache,
+                               { .stage = { .stage = vk::ShaderStageFlagBits::eCompute,
+                                            .module = shader.vk_module,
+                                            .pName = d.shader.entry_point.c_str() },
+                                 .layout = d.layout },
+                               nullptr, *c.dispatcher)
+        .value;
+}
+
+template <class Description>
+pipeline_handle
+enqueue(pipeline_compiler::impl& c, Description description)
+{
+    auto* const shared{ c.shared.get() };
+
+    pipeline_handle h;
+    {
+        std::scoped_lock const lock{ shared->mutex };
+
+        h.index = static_cast<std::uint32_t>(shared->entries.size());
+        shared->entries.emplace_back();
+    }
+
+    // `c` may be moved while task is queued, so only stable parts of it are captured
+    c.pool->submit(
+        [context = compile_context{ .vk_device = c.vk_device,
+                                    .dispatcher = c.dispatcher,
+                                    .vk_pipeline_cache = c.vk_pipeline_cache },
+         shared, h, description = std::move(description)]
+        {
+            ORBI_TRACE_SCOPE("pipeline_compiler::compile");
+
+            vk::Pipeline pipeline{};
+            std::string error;
+
+            try
+            {
+                pipeline = create(context, description);
+            }
+            catch (std::exception const& e)
+            {
+                error = e.what();
+            }
+            catch (...)
+            {
+                error = "unknown exception";
+            }
+
+            {
+                std::scoped_lock const lock{ shared->mutex };
+
+                auto& e{ shared->entries[h.index] };
+                e.pipeline = pipeline;
+                e.status = pipeline ? pipeline_status::ready : pipeline_status::failed;
+                e.error = std::move(error);
+            }
+
+            shared->finished.notify_all();
+        });
+
+    return h;
+}
+
+} // namespace
+
+pipeline_compiler::pipeline_compiler(device const& dev, std::uint32_t const thread_count)
+try
+{
+    auto const& dev_impl{ device::impl::from_device(dev) };
+
+    data->vk_device = *dev_impl.vk_device;
+    data->dispatcher = dev_impl.vk_device.getDispatcher();
+    data->vk_pipeline_cache = *pipeline_cache::impl::from_pipeline_cache(dev.cache()).vk_pipeline_cache;
+    data->pool = std::make_unique<detail::thread_pool>(thread_count);
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "pipeline_compiler::pipeline_compiler: failed to start worker threads" });
+}
+
+pipeline_compiler::~pipeline_compiler()
+{
+    if (!data->pool)
+    {
+        return;
+    }
+
+    // queued compilations still reference `shared`
+    data->pool.reset();
+
+    for (auto const& e : data->shared->entries)
+    {
+        if (e.pipeline)
+        {
+            data->vk_device.destroyPipeline(e.pipeline, nullptr, *data->dispatcher);
+        }
+    }
+}
+
+pipeline_compiler::pipeline_compiler(pipeline_compiler&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+pipeline_compiler&
+pipeline_compiler::operator=(pipeline_compiler other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(pipeline_compiler& l, pipeline_compiler& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+pipeline_handle
+pipeline_compiler::compile(graphics_pipeline_description description)
+{
+    return enqueue(*data, std::move(description));
+}
+
+pipeline_handle
+pipeline_compiler::compile(compute_pipeline_description description)
+{
+    return enqueue(*data, std::move(description));
+}
+
+pipeline_status
+pipeline_compiler::status(pipeline_handle const h) const
+{
+    assert(h);
+
+    std::scoped_lock const lock{ data->shared->mutex };
+
+    return data->shared->entries.at(h.index).status;
+}
+
+vk::Pipeline
+pipeline_compiler::get(pipeline_handle const h) const
+{
+    if (!h)
+    {
+        return {};
+    }
+
+    std::scoped_lock const lock{ data->shared->mutex };
+
+    return data->shared->entries.at(h.index).pipeline;
+}
+
+vk::Pipeline
+pipeline_compiler::get_or(pipeline_handle const h, pipeline_handle const fallback) const
+{
+    if (auto const pipeline{ get(h) })
+    {
+        return pipeline;
+    }
+
+    return get(fallback);
+}
+
+vk::Pipeline
+pipeline_compiler::wait(pipeline_handle const h) const
+{
+    assert(h);
+
+    auto& shared{ *data->shared };
+    std::unique_lock lock{ shared.mutex };
+
+    shared.finished.wait(lock, [&] { return shared.entries.at(h.index).status != pipeline_status::pending; });
+
+    auto const& e{ shared.entries[h.index] };
+    if (e.status == pipeline_status::failed)
+    {
+        throw error{ "pipeline_compiler::wait: compilation of pipeline {} failed: {}", h.index, e.error };
+    }
+
+    return e.pipeline;
+}
+
+void
+pipeline_compiler::wait_until_idle() const
+{
+    data->pool->wait_until_idle();
+}
+
+} // namespace orbi
@@ -0,0 +1,369 @@
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/gpu_allocator.hpp>
+#include <orbi/offscreen_target.hpp>
+#include <orbi/readback_stream.hpp>
+#include <orbi/rendering.hpp>
+#include <orbi/trace.hpp>
+
+#include <vulkan/vulkan_format_traits.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace orbi
+{
+
+namespace
+{
+
+void
+release(readback_stream::impl::state& shared) noexcept
+{
+    for (auto& slot : shared.slots)
+    {
+        slot.buffer = nullptr;
+        shared.allocator->free(slot.allocation);
+    }
+}
+
+vk::DeviceSize
+frame_size(vk::Extent2D const extent, vk::Format const format)
+{
+    return vk::DeviceSize{ extent.width } * extent.height * vk::blockSize(format);
+}
+
+void
+throw_if_failed(readback_stream::impl::state const& shared, std::string_view const fn)
+{
+    if (!shared.error.empty())
+    {
+        throw readback_stream::error{ "readback_stream::{}: consumer failed: {}", fn, shared.error };
+    }
+}
+
+// runs on worker thread in order of `push`
+void
+consume_frame(readback_stream::impl::state& shared, readback_stream::impl::slot& slot,
+              readback_frame const& frame) noexcept
+{
+    ORBI_TRACE_SCOPE("readback_stream::consume");
+
+    bool stopped{ false };
+    {
+        std::scoped_lock const lock{ shared.mutex };
+        stopped = !shared.error.empty();
+    }
+
+    std::string failure;
+    try
+    {
+        // copy must be finished before slot is freed, even if stream is stopped
+        // timeout is infinite, so it can't return `vk::Result::eTimeout`
+        static_cast<void>(shared.vk_device->waitForFences(*slot.copied, vk::True,
+                                                          std::numeric_limits<std::uint64_t>::max()));
+
+        if (!stopped)
+        {
+            // `memory_usage::readback` memory is coherent, copy is made visible to host by barrier
+            shared.consume(frame);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        failure = e.what();
+    }
+    catch (...)
+    {
+        failure = "unknown exception";
+    }
+
+    {
+        std::scoped_lock const lock{ shared.mutex };
+
+        if (!stopped && failure.empty())
+        {
+            ++shared.stats.frames_consumed;
+            shared.stats.bytes_consumed += frame.pixels.size();
+        }
+
+        if (shared.error.empty())
+        {
+            shared.error = std::move(failure);
+        }
+
+        slot.busy = false;
+    }
+
+    shared.freed.notify_all();
+}
+
+} // namespace
+
+readback_stream::readback_stream(device const& dev, vk::Extent2D const extent, vk::Format const format,
+                                 consumer consume, std::uint32_t const depth)
+try
+{
+    assert(depth > 0);
+    assert(consume);
+
+    auto const& dev_impl{ device::impl::from_device(dev) };
+    auto const& vk_device{ dev_impl.vk_device };
+
+    data->dev = &dev_impl;
+    data->extent = extent;
+    data->format = format;
+    data->shared = std::make_unique<impl::state>();
+
+    auto& shared{ *data->shared };
+    shared.vk_device = &vk_device;
+    shared.allocator = &dev.allocator();
+    shared.consume = std::move(consume);
+    shared.slots.resize(depth);
+
+    // memory isn't owned by raii members, so it is freed by hand if stream can't be completed
+    try
+    {
+        for (auto& slot : shared.slots)
+        {
+            slot.command_pool = vk::raii::CommandPool{
+                vk_device, vk::CommandPoolCreateInfo{ .flags = vk::CommandPoolCreateFlagBits::eTransient,
+                                                      .queueFamilyIndex = dev_impl.graphics_queue.family_index }
+            };
+
+            slot.command_buffer = std::move(vk_device
+                                                .allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+                                                    .commandPool = slot.command_pool,
+                                                    .level = vk::CommandBufferLevel::ePrimary,
+                                                    .commandBufferCount = 1 })
+                                                .front());
+
+            slot.buffer = vk::raii::Buffer{ vk_device,
+                                            vk::BufferCreateInfo{ .size = frame_size(extent, format),
+                                                                  .usage = vk::BufferUsageFlagBits::eTransferDst } };
+
+            slot.allocation = shared.allocator->allocate(
+                { .requirements = slot.buffer.getMemoryRequirements(), .usage = memory_usage::readback });
+            slot.buffer.bindMemory(slot.allocation.memory, slot.allocation.offset);
+
+            slot.copied = vk::raii::Fence{ vk_device, vk::FenceCreateInfo{} };
+
+            auto const index{ &slot - shared.slots.data() };
+            dev_impl.set_name(*slot.command_buffer, "orbi::readback_stream slot {} command buffer", index);
+            dev_impl.set_name(*slot.buffer, "orbi::readback_stream slot {} buffer", index);
+            dev_impl.set_name(*slot.copied, "orbi::readback_stream slot {} copied", index);
+        }
+
+        data->pool = std::make_unique<detail::thread_pool>(1);
+    }
+    catch (...)
+    {
+        release(shared);
+        throw;
+    }
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "readback_stream::readback_stream: Internal call to vulkan failed" });
+}
+
+readback_stream::~readback_stream()
+{
+    if (!data->pool)
+    {
+        return;
+    }
+
+    // queued frames still reference `shared`, each of them waits for its copy
+    data->pool.reset();
+
+    release(*data->shared);
+}
+
+readback_stream::readback_stream(readback_stream&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+readback_stream&
+readback_stream::operator=(readback_stream other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(readback_stream& l, readback_stream& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+void
+readback_stream::push(vk::Image const image, image_state const& state)
+{
+    ORBI_TRACE_SCOPE("readback_stream::push");
+
+    auto& shared{ *data->shared };
+    auto& slot{ shared.slots[data->next_slot] };
+
+    {
+        std::unique_lock lock{ shared.mutex };
+
+        if (slot.busy)
+        {
+            ++shared.stats.stalls;
+            shared.freed.wait(lock, [&] { return !slot.busy; });
+        }
+
+        throw_if_failed(shared, "push");
+
+        slot.busy = true;
+    }
+
+    bool submitted{ false };
+    try
+    {
+        data->dev->vk_device.resetFences(*slot.copied);
+        slot.command_pool.reset();
+
+        auto const& command_buffer{ slot.command_buffer };
+        command_buffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        data->dev->begin_label(command_buffer, "orbi::readback_stream::push");
+
+        // rendering was submitted earlier to the same queue, so barrier is ordered after it
+        transition(command_buffer, image, state, image_states::transfer_source);
+
+        command_buffer.copyImageToBuffer(
+            image, vk::ImageLayout::eTransferSrcOptimal, slot.buffer,
+            vk::BufferImageCopy{ .imageSubresource = { .aspectMask = vk::ImageAspectFlagBits::eColor, .layerCount = 1 },
+                                 .imageExtent = { data->extent.width, data->extent.height, 1 } });
+
+        // fence alone doesn't make device writes visible to host
+        vk::MemoryBarrier2 const to_host{ .srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+                                          .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+                                          .dstStageMask = vk::PipelineStageFlagBits2::eHost,
+                                          .dstAccessMask = vk::AccessFlagBits2::eHostRead };
+        command_buffer.pipelineBarrier2({ .memoryBarrierCount = 1, .pMemoryBarriers = &to_host });
+
+        data->dev->end_label(command_buffer);
+        command_buffer.end();
+
+        vk::CommandBufferSubmitInfo const command_buffer_info{ .commandBuffer = command_buffer };
+        data->dev->graphics_queue.vk_queue.submit2(
+            vk::SubmitInfo2{ .commandBufferInfoCount = 1, .pCommandBufferInfos = &command_buffer_info },
+            slot.copied);
+        submitted = true;
+
+        readback_frame const frame{
+            .index = data->next_index,
+            .extent = data->extent,
+            .format = data->format,
+            .pixels = { slot.allocation.mapped, static_cast<std::size_t>(frame_size(data->extent, data->format)) }
+        };
+
+        data->pool->submit([&shared, &slot, frame] { consume_frame(shared, slot, frame); });
+    }
+    catch (...)
+    {
+        // copy is already executing, slot can't be reused until it's finished
+        if (submitted)
+        {
+            try
+            {
+                static_cast<void>(data->dev->vk_device.waitForFences(*slot.copied, vk::True,
+                                                                     std::numeric_limits<std::uint64_t>::max()));
+            }
+            catch (...)
+            {
+                // device is lost, nothing is executed anymore
+            }
+        }
+
+        {
+            std::scoped_lock const lock{ shared.mutex };
+            slot.busy = false;
+        }
+
+        std::throw_with_nested(error{ "readback_stream::push: Internal call to vulkan failed" });
+    }
+
+    data->next_slot = (data->next_slot + 1) % static_cast<std::uint32_t>(shared.slots.size());
+    ++data->next_index;
+}
+
+void
+readback_stream::push(offscreen_target const& target, image_state const& state)
+{
+    assert(target.extent() == data->extent);
+    assert(target.format() == data->format);
+
+    push(target.image(), state);
+}
+
+void
+readback_stream::flush()
+{
+    data->pool->wait_until_idle();
+
+    std::scoped_lock const lock{ data->shared->mutex };
+    throw_if_failed(*data->shared, "flush");
+}
+
+readback_stats
+readback_stream::stats() const
+{
+    std::scoped_lock const lock{ data->shared->mutex };
+
+    return data->shared->stats;
+}
+
+readback_stream::consumer
+write_to(int const fd)
+{
+    return [fd](readback_frame const& frame)
+    {
+        auto const* bytes{ frame.pixels.data() };
+        auto left{ frame.pixels.size() };
+
+        while (left > 0)
+        {
+#ifdef _WIN32
+            auto const written{ ::_write(fd, bytes, static_cast<unsigned int>(std::min<std::size_t>(left, INT_MAX))) };
+#else
+            auto const written{ ::write(fd, bytes, left) };
+#endif
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                throw readback_stream::error{ "write_to: write of frame {} failed with: '{}'", frame.index,
+                                              std::strerror(errno) };
+            }
+
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            bytes += written;
+            left -= static_cast<std::size_t>(written);
+        }
+    };
+}
+
+} // namespace orbi
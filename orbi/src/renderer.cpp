@@ -0,0 +1,164 @@
+#include <orbi/deletion_queue.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/renderer.hpp>
+#include <orbi/timeline.hpp>
+#include <orbi/trace.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cassert>
+#include <memory>
+#include <utility>
+
+namespace orbi
+{
+
+renderer::renderer(device const& dev, frame_index_type const frames_in_flight)
+try
+{
+    assert(frames_in_flight > 0);
+
+    auto const& dev_impl{ device::impl::from_device(dev) };
+    auto const& vk_device{ dev_impl.vk_device };
+
+    data->dev = &dev_impl;
+    data->frame_timeline = std::make_unique<timeline>(dev);
+    data->frames.reserve(frames_in_flight);
+
+    for (frame_index_type i{ 0 }; i < frames_in_flight; ++i)
+    {
+        impl::frame frame;
+
+        // whole pool is reset at once in `begin_frame`, it's cheaper than resetting buffers one by one
+        frame.command_pool = vk::raii::CommandPool{
+            vk_device, vk::CommandPoolCreateInfo{ .flags = vk::CommandPoolCreateFlagBits::eTransient,
+                                                  .queueFamilyIndex = dev_impl.graphics_queue.family_index }
+        };
+
+        frame.command_buffer = std::move(vk_device
+                                             .allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+                                                 .commandPool = frame.command_pool,
+                                                 .level = vk::CommandBufferLevel::ePrimary,
+                                                 .commandBufferCount = 1 })
+                                             .front());
+
+        frame.image_available = vk::raii::Semaphore{ vk_device, vk::SemaphoreCreateInfo{} };
+
+        dev_impl.set_name(*frame.command_buffer, "orbi::renderer frame {} command buffer", i);
+        dev_impl.set_name(*frame.image_available, "orbi::renderer frame {} image_available", i);
+
+        data->frames.push_back(std::move(frame));
+    }
+}
+catch (renderer::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "renderer::renderer: Internal call to vulkan failed" });
+}
+
+renderer::~renderer()
+{
+    if (!data->frame_timeline)
+    {
+        return;
+    }
+
+    // command buffers and semaphores of frames can't be destroyed while gpu still uses them
+    try
+    {
+        data->frame_timeline->wait(data->frame_timeline->last());
+    }
+    catch (...)
+    {
+        // device is lost, gpu doesn't execute anything anymore
+    }
+}
+
+renderer::renderer(renderer&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+renderer&
+renderer::operator=(renderer other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(renderer& l, renderer& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+renderer::frame_index_type
+renderer::frames_in_flight() const noexcept
+{
+    return static_cast<frame_index_type>(data->frames.size());
+}
+
+renderer::frame_index_type
+renderer::current_frame() const noexcept
+{
+    return data->current_frame;
+}
+
+timeline const&
+renderer::frame_timeline() const noexcept
+{
+    return *data->frame_timeline;
+}
+
+void
+renderer::wait_for(timeline const& t, timeline::value_type const value, vk::PipelineStageFlags2 const stage)
+{
+    data->current().waits.push_back(t.submit_info(value, stage));
+}
+
+void
+renderer::begin_frame()
+{
+    ORBI_TRACE_SCOPE("renderer::begin_frame");
+
+    auto& frame{ data->current() };
+
+    // frame which was skipped (e.g. out of date swapchain) keeps value of its previous submission,
+    // so it doesn't deadlock here
+    try
+    {
+        data->frame_timeline->wait(frame.submitted);
+    }
+    catch (timeline::error const&)
+    {
+        std::throw_with_nested(error{ "renderer::begin_frame: waiting for previous use of frame failed" });
+    }
+
+    frame.command_pool.reset();
+    frame.waits.clear();
+
+    // timeline was just polled, so it's the cheapest moment to release what finished frames used
+    try
+    {
+        data->dev->deletion->collect();
+    }
+    catch (deletion_queue::error const&)
+    {
+        std::throw_with_nested(error{ "renderer::begin_frame: collecting deletion queue failed" });
+    }
+}
+
+void
+renderer::end_frame() noexcept
+{
+    data->current_frame = (data->current_frame + 1) % frames_in_flight();
+}
+
+} // namespace orbi
@@ -0,0 +1,65 @@
+#include <orbi/rendering.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+namespace orbi
+{
+
+namespace
+{
+
+constexpr std::size_t max_color_attachments{ 8 };
+
+} // namespace
+
+void
+transition(vk::raii::CommandBuffer const& command_buffer, vk::Image const image, image_state const& from,
+           image_state const& to, vk::ImageAspectFlags const aspect)
+{
+    vk::ImageMemoryBarrier2 const barrier{ .srcStageMask = from.stage,
+                                           .srcAccessMask = from.access,
+                                           .dstStageMask = to.stage,
+                                           .dstAccessMask = to.access,
+                                           .oldLayout = from.layout,
+                                           .newLayout = to.layout,
+                                           .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                           .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                           .image = image,
+                                           .subresourceRange = { .aspectMask = aspect,
+                                                                 .baseMipLevel = 0,
+                                                                 .levelCount = vk::RemainingMipLevels,
+                                                                 .baseArrayLayer = 0,
+                                                                 .layerCount = vk::RemainingArrayLayers } };
+
+    command_buffer.pipelineBarrier2({ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &barrier });
+}
+
+void
+begin_rendering(vk::raii::CommandBuffer const& command_buffer, vk::Rect2D const area,
+                std::span<color_attachment_info const> const colors, vk::RenderingFlags const flags)
+{
+    assert(colors.size() <= max_color_attachments);
+
+    std::array<vk::RenderingAttachmentInfo, max_color_attachments> attachments{};
+    std::ranges::transform(colors, begin(attachments),
+                           [](color_attachment_info const& c) -> vk::RenderingAttachmentInfo
+                           {
+                               return { .imageView = c.view,
+                                        .imageLayout = vk::ImageLayout::eColorAttachmentOptimal,
+                                        .loadOp = c.load_op,
+                                        .storeOp = c.store_op,
+                                        .clearValue = c.clear_color };
+                           });
+
+    command_buffer.beginRendering({ .flags = flags,
+                                    .renderArea = area,
+                                    .layerCount = 1,
+                                    .colorAttachmentCount = static_cast<std::uint32_t>(colors.size()),
+                                    .pColorAttachments = attachments.data() });
+}
+
+} // namespace orbi
@@ -0,0 +1,308 @@
+#include <orbi/deletion_queue.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/renderer.hpp>
+#include <orbi/swapchain.hpp>
+#include <orbi/trace.hpp>
+#include <orbi/window.hpp>
+
+#include <SDL3/SDL_video.h>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <utility>
+
+namespace orbi
+{
+
+namespace
+{
+
+struct retired_swapchain
+{
+    vk::raii::SwapchainKHR vk_swapchain;
+    std::vector<vk::raii::ImageView> image_views;
+    std::vector<vk::raii::Semaphore> render_finished;
+};
+
+vk::SurfaceFormatKHR
+choose_surface_format(std::vector<vk::SurfaceFormatKHR> const& formats)
+{
+    if (formats.empty())
+    {
+        throw swapchain::error{ "swapchain: surface doesn't support any format" };
+    }
+
+    auto const preferred{ std::ranges::find(
+        formats, vk::SurfaceFormatKHR{ vk::Format::eB8G8R8A8Srgb, vk::ColorSpaceKHR::eSrgbNonlinear }) };
+
+    return preferred != end(formats) ? *preferred : formats.front();
+}
+
+vk::Extent2D
+choose_extent(swapchain::impl const& sc, vk::SurfaceCapabilitiesKHR const& capabilities)
+{
+    // if false, extent is determined by surface
+    if (capabilities.currentExtent != vk::Extent2D{ 0xFFFFFFFF, 0xFFFFFFFF })
+    {
+        return capabilities.currentExtent;
+    }
+
+    int width{ 0 };
+    int height{ 0 };
+    if (!SDL_GetWindowSizeInPixels(sc.win->sdl_window, &width, &height))
+    {
+        throw swapchain::error{ "SDL_GetWindowSizeInPixels failed with: '{}'", SDL_GetError() };
+    }
+
+    return { .width = std::clamp(static_cast<std::uint32_t>(width), capabilities.minImageExtent.width,
+                                 capabilities.maxImageExtent.width),
+             .height = std::clamp(static_cast<std::uint32_t>(height), capabilities.minImageExtent.height,
+                                  capabilities.maxImageExtent.height) };
+}
+
+/*
+    @return `false` if swapchain can't be created now, e.g. window is minimized
+*/
+bool
+recreate(swapchain::impl& sc, renderer const* const r)
+{
+    ORBI_TRACE_SCOPE("swapchain::recreate");
+
+    auto const& vk_device{ sc.dev->vk_device };
+    auto const& vk_physical_device{ sc.dev->vk_physical_device };
+    auto* const surface{ sc.win->vk_surface };
+
+    auto const capabilities{ vk_physical_device.getSurfaceCapabilitiesKHR(surface) };
+    auto const extent{ choose_extent(sc, capabilities) };
+    if (extent.width == 0 || extent.height == 0)
+    {
+        return false;
+    }
+
+    auto const max_image_count = capabilities.maxImageCount == 0 ? std::numeric_limits<std::uint32_t>::max()
+                                                                  : capabilities.maxImageCount;
+    auto const image_count = std::clamp(3u, capabilities.minImageCount, max_image_count);
+
+    std::vector const unique_queue_families = [&]
+    {
+        std::vector families{ sc.dev->graphics_queue.family_index, sc.dev->present_queue.family_index };
+        std::ranges::sort(families);
+        auto const [first, last] = std::ranges::unique(families);
+        families.erase(first, last);
+
+        return families;
+    }();
+
+    auto const sharing_mode = unique_queue_families.size() == 1 ? vk::SharingMode::eExclusive
+                                                                : vk::SharingMode::eConcurrent;
+
+    vk::raii::SwapchainKHR new_swapchain{
+        vk_device,
+        { .surface = surface,
+          .minImageCount = image_count,
+          .imageFormat = sc.surface_format.format,
+          .imageColorSpace = sc.surface_format.colorSpace,
+          .imageExtent = extent,
+          .imageArrayLayers = 1,
+          .imageUsage = vk::ImageUsageFlagBits::eColorAttachment,
+          .imageSharingMode = sharing_mode,
+          .queueFamilyIndexCount = static_cast<std::uint32_t>(unique_queue_families.size()),
+          .pQueueFamilyIndices = unique_queue_families.data(),
+          .preTransform = capabilities.currentTransform,
+          .compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque,
+          .presentMode = sc.present_mode,
+          .clipped = vk::True,
+          .oldSwapchain = *sc.vk_swapchain }
+    };
+
+    // images of old swapchain may still be rendered to or presented by frames in flight
+    if (*sc.vk_swapchain)
+    {
+        assert(r);
+
+        sc.dev->deletion->push(*r, retired_swapchain{ .vk_swapchain = std::move(sc.vk_swapchain),
+                                                      .image_views = std::move(sc.image_views),
+                                                      .render_finished = std::move(sc.render_finished) });
+    }
+
+    sc.vk_swapchain = std::move(new_swapchain);
+    sc.extent = extent;
+    sc.dev->set_name(*sc.vk_swapchain, "orbi::swapchain {}", sc.generation + 1);
+
+    auto const images{ sc.vk_swapchain.getImages() };
+    sc.images.assign(begin(images), end(images));
+
+    sc.image_views.clear();
+    sc.render_finished.clear();
+    for (auto const& image : sc.images)
+    {
+        sc.image_views.emplace_back(vk_device,
+                                    vk::ImageViewCreateInfo{
+                                        .image = image,
+                                        .viewType = vk::ImageViewType::e2D,
+                                        .format = sc.surface_format.format,
+                                        .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                                              .baseMipLevel = 0,
+                                                              .levelCount = 1,
+                                                              .baseArrayLayer = 0,
+                                                              .layerCount = 1 } });
+
+        sc.render_finished.emplace_back(vk_device, vk::SemaphoreCreateInfo{});
+
+        auto const index{ sc.image_views.size() - 1 };
+        sc.dev->set_name(image, "orbi::swapchain image {}", index);
+        sc.dev->set_name(*sc.image_views.back(), "orbi::swapchain image view {}", index);
+        sc.dev->set_name(*sc.render_finished.back(), "orbi::swapchain render_finished {}", index);
+    }
+
+    sc.out_of_date = false;
+    ++sc.generation;
+
+    return true;
+}
+
+} // namespace
+
+swapchain::swapchain(device const& dev, window const& win)
+try
+{
+    if (dev.headless())
+    {
+        throw error{ "swapchain::swapchain: device is headless, it can't present" };
+    }
+
+    data->dev = &device::impl::from_device(dev);
+    data->win = &window::impl::from_window(win);
+
+    auto const& vk_physical_device{ data->dev->vk_physical_device };
+    auto* const surface{ data->win->vk_surface };
+
+    data->surface_format = choose_surface_format(vk_physical_device.getSurfaceFormatsKHR(surface));
+
+    // the only mode, which is required to be supported
+    data->present_mode = vk::PresentModeKHR::eFifo;
+
+    // there is no old swapchain to retire yet
+    recreate(*data, nullptr);
+}
+catch (swapchain::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "swapchain::swapchain: Internal call to vulkan failed" });
+}
+
+swapchain::~swapchain() = default;
+
+swapchain::swapchain(swapchain&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+swapchain&
+swapchain::operator=(swapchain other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(swapchain& l, swapchain& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+std::optional<swapchain::image_index_type>
+swapchain::acquire(renderer const& r)
+try
+{
+    ORBI_TRACE_SCOPE("swapchain::acquire");
+
+    auto const& frame{ renderer::impl::from_renderer(r).current() };
+
+    if (data->out_of_date && !recreate(*data, &r))
+    {
+        return std::nullopt;
+    }
+
+    try
+    {
+        auto const [result, image_index]{ data->vk_swapchain.acquireNextImage(
+            std::numeric_limits<std::uint64_t>::max(), frame.image_available) };
+
+        if (result == vk::Result::eSuboptimalKHR)
+        {
+            // image is acquired and semaphore will be signaled, so it still must be rendered and presented
+            data->out_of_date = true;
+        }
+
+        return image_index;
+    }
+    catch (vk::OutOfDateKHRError const&)
+    {
+        data->out_of_date = true;
+
+        return std::nullopt;
+    }
+}
+catch (swapchain::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "swapchain::acquire: Internal call to vulkan failed" });
+}
+
+void
+swapchain::present(image_index_type const image_index)
+try
+{
+    ORBI_TRACE_SCOPE("swapchain::present");
+
+    try
+    {
+        auto const result{ data->dev->present_queue.vk_queue.presentKHR(
+            { .waitSemaphoreCount = 1,
+              .pWaitSemaphores = &*data->render_finished.at(image_index),
+              .swapchainCount = 1,
+              .pSwapchains = &*data->vk_swapchain,
+              .pImageIndices = &image_index }) };
+
+        if (result == vk::Result::eSuboptimalKHR)
+        {
+            data->out_of_date = true;
+        }
+    }
+    catch (vk::OutOfDateKHRError const&)
+    {
+        data->out_of_date = true;
+    }
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "swapchain::present: Internal call to vulkan failed" });
+}
+
+void
+swapchain::invalidate() noexcept
+{
+    data->out_of_date = true;
+}
+
+std::uint64_t
+swapchain::generation() const noexcept
+{
+    return data->generation;
+}
+
+} // namespace orbi
@@ -0,0 +1,110 @@
+#include <orbi/detail/thread_pool.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace orbi::detail
+{
+
+thread_pool::thread_pool(std::uint32_t thread_count)
+{
+    if (thread_count == 0)
+    {
+        // one hardware thread is left for thread, which submits work
+        thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    threads.reserve(thread_count);
+
+    try
+    {
+        for (std::uint32_t i{ 0 }; i < thread_count; ++i)
+        {
+            threads.emplace_back([this] { run(); });
+        }
+    }
+    catch (...)
+    {
+        // destructor isn't called for partially constructed pool, but started threads use it
+        stop();
+        throw;
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    stop();
+}
+
+void
+thread_pool::stop() noexcept
+{
+    {
+        std::scoped_lock const lock{ mutex };
+        stopping = true;
+    }
+
+    task_available.notify_all();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void
+thread_pool::submit(task_type task)
+{
+    {
+        std::scoped_lock const lock{ mutex };
+        tasks.push_back(std::move(task));
+    }
+
+    task_available.notify_one();
+}
+
+void
+thread_pool::wait_until_idle()
+{
+    std::unique_lock lock{ mutex };
+    idle.wait(lock, [this] { return tasks.empty() && running == 0; });
+}
+
+std::uint32_t
+thread_pool::thread_count() const noexcept
+{
+    return static_cast<std::uint32_t>(threads.size());
+}
+
+void
+thread_pool::run()
+{
+    std::unique_lock lock{ mutex };
+
+    while (true)
+    {
+        task_available.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+        if (tasks.empty())
+        {
+            // stopping and nothing left to do
+            return;
+        }
+
+        auto task{ std::move(tasks.front()) };
+        tasks.pop_front();
+        ++running;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        --running;
+        if (tasks.empty() && running == 0)
+        {
+            idle.notify_all();
+        }
+    }
+}
+
+} // namespace orbi::detail
@@ -0,0 +1,172 @@
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/timeline.hpp>
+#include <orbi/trace.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace orbi
+{
+
+timeline::timeline(device const& dev, value_type const initial_value)
+try
+{
+    auto const& dev_impl{ device::impl::from_device(dev) };
+
+    vk::SemaphoreTypeCreateInfo const type_info{ .semaphoreType = vk::SemaphoreType::eTimeline,
+                                                 .initialValue = initial_value };
+
+    data->semaphore = vk::raii::Semaphore{ dev_impl.vk_device, vk::SemaphoreCreateInfo{ .pNext = &type_info } };
+    data->shared = std::make_shared<impl::shared_state>();
+    data->shared->vk_device = *dev_impl.vk_device;
+    data->shared->dispatcher = dev_impl.vk_device.getDispatcher();
+    data->shared->semaphore = *data->semaphore;
+    data->shared->next.store(initial_value);
+    data->shared->completed.store(initial_value);
+
+    dev_impl.set_name(*data->semaphore, "orbi::timeline");
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "timeline::timeline: Internal call to vulkan failed" });
+}
+
+timeline::~timeline()
+{
+    if (!data->shared)
+    {
+        return;
+    }
+
+    try
+    {
+        wait(last());
+    }
+    catch (...)
+    {
+        // device is lost, gpu doesn't execute anything anymore
+    }
+
+    std::scoped_lock const lock{ data->shared->mutex };
+
+    data->shared->completed.store(std::numeric_limits<value_type>::max());
+    data->semaphore.clear();
+}
+
+timeline::timeline(timeline&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+timeline&
+timeline::operator=(timeline other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(timeline& l, timeline& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+vk::Semaphore
+timeline::semaphore() const noexcept
+{
+    return data->semaphore;
+}
+
+timeline::value_type
+timeline::advance() noexcept
+{
+    return data->shared->next.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+timeline::value_type
+timeline::last() const noexcept
+{
+    return data->shared->next.load(std::memory_order_relaxed);
+}
+
+timeline::value_type
+timeline::cached() const noexcept
+{
+    return data->shared->completed.load(std::memory_order_relaxed);
+}
+
+timeline::value_type
+timeline::completed() const
+try
+{
+    return impl::poll(*data->shared);
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "timeline::completed: Internal call to vulkan failed" });
+}
+
+bool
+timeline::reached(value_type const value) const
+{
+    return cached() >= value || completed() >= value;
+}
+
+bool
+timeline::wait(value_type const value, std::chrono::nanoseconds const timeout) const
+try
+{
+    if (cached() >= value)
+    {
+        return true;
+    }
+
+    ORBI_TRACE_SCOPE("timeline::wait");
+
+    auto const semaphore{ *data->semaphore };
+    auto const result{ data->semaphore.getDevice().waitSemaphores(
+        vk::SemaphoreWaitInfo{ .semaphoreCount = 1, .pSemaphores = &semaphore, .pValues = &value },
+        static_cast<std::uint64_t>(timeout.count()), *data->semaphore.getDispatcher()) };
+
+    if (result == vk::Result::eTimeout)
+    {
+        return false;
+    }
+
+    impl::update_cached(*data->shared, value);
+
+    return true;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "timeline::wait: Internal call to vulkan failed" });
+}
+
+void
+timeline::signal(value_type const value) const
+try
+{
+    data->semaphore.getDevice().signalSemaphore({ .semaphore = data->semaphore, .value = value },
+                                                 *data->semaphore.getDispatcher());
+    impl::update_cached(*data->shared, value);
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "timeline::signal: Internal call to vulkan failed" });
+}
+
+vk::SemaphoreSubmitInfo
+timeline::submit_info(value_type const value, vk::PipelineStageFlags2 const stage) const noexcept
+{
+    return { .semaphore = data->semaphore, .value = value, .stageMask = stage };
+}
+
+} // namespace orbi
@@ -0,0 +1,364 @@
+#include <orbi/detail/tlsf.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <limits>
+
+namespace orbi::detail
+{
+
+tlsf::tlsf(size_type const capacity)
+    : total_size{ capacity }
+{
+    for (auto& heads : free_heads)
+    {
+        heads.fill(npos);
+    }
+
+    if (capacity > 0)
+    {
+        auto const n{ make_node() };
+        nodes[n].offset = 0;
+        nodes[n].size = capacity;
+        insert_free(n);
+    }
+}
+
+std::optional<tlsf::allocation>
+tlsf::allocate(size_type size, size_type const alignment)
+{
+    assert(std::has_single_bit(alignment));
+
+    size = std::max(size, size_type{ 1 });
+
+    // any range of this size can hold `size` bytes after aligning its start
+    auto const search_size{ size + alignment - 1 };
+    if (search_size < size)
+    {
+        return std::nullopt;
+    }
+
+    auto n{ npos };
+    if (auto const c{ find_suitable_class(search_size) })
+    {
+        n = free_heads[c->fl][c->sl];
+    } else
+    {
+        // rounding up to the next class skips ranges of the same and next classes, which still may fit,
+        // it matters when memory is almost exhausted, so these classes are scanned linearly
+        n = find_in_class(size, alignment);
+        if (n == npos)
+        {
+            return std::nullopt;
+        }
+    }
+
+    remove_free(n);
+
+    auto const offset{ nodes[n].offset };
+    auto const aligned_offset{ (offset + alignment - 1) & ~(alignment - 1) };
+    if (aligned_offset > offset)
+    {
+        auto const aligned{ split(n, aligned_offset - offset) };
+        insert_free(n);
+        n = aligned;
+    }
+
+    if (nodes[n].size > size)
+    {
+        insert_free(split(n, size));
+    }
+
+    used_size += nodes[n].size;
+    ++allocations;
+
+    return allocation{ .offset = nodes[n].offset, .size = nodes[n].size, .node = n };
+}
+
+void
+tlsf::free(allocation const& a) noexcept
+{
+    auto n{ a.node };
+
+    assert(n < nodes.size() && !nodes[n].free);
+
+    used_size -= nodes[n].size;
+    --allocations;
+
+    if (auto const prev{ nodes[n].prev_physical }; prev != npos && nodes[prev].free)
+    {
+        remove_free(prev);
+        merge(prev, n);
+        n = prev;
+    }
+
+    if (auto const next{ nodes[n].next_physical }; next != npos && nodes[next].free)
+    {
+        remove_free(next);
+        merge(n, next);
+    }
+
+    insert_free(n);
+}
+
+tlsf::size_type
+tlsf::capacity() const noexcept
+{
+    return total_size;
+}
+
+tlsf::size_type
+tlsf::used() const noexcept
+{
+    return used_size;
+}
+
+tlsf::size_type
+tlsf::largest_free() const noexcept
+{
+    if (fl_bitmap == 0)
+    {
+        return 0;
+    }
+
+    // the largest range is in the highest non empty class, but class isn't sorted
+    auto const fl{ static_cast<unsigned>(std::bit_width(fl_bitmap) - 1) };
+    auto const sl{ static_cast<unsigned>(std::bit_width(sl_bitmaps[fl]) - 1) };
+
+    size_type largest{ 0 };
+    for (auto n{ free_heads[fl][sl] }; n != npos; n = nodes[n].next_free)
+    {
+        largest = std::max(largest, nodes[n].size);
+    }
+
+    return largest;
+}
+
+std::uint32_t
+tlsf::allocation_count() const noexcept
+{
+    return allocations;
+}
+
+std::uint32_t
+tlsf::free_range_count() const noexcept
+{
+    return free_ranges;
+}
+
+tlsf::size_class
+tlsf::class_of(size_type const size) noexcept
+{
+    // small sizes are mapped linearly into the first class
+    if (size < sl_count)
+    {
+        return { .fl = 0, .sl = static_cast<unsigned>(size) };
+    }
+
+    auto const msb{ static_cast<unsigned>(std::bit_width(size) - 1) };
+
+    return { .fl = msb - sl_log2 + 1, .sl = static_cast<unsigned>(size >> (msb - sl_log2)) - sl_count };
+}
+
+std::optional<tlsf::size_class>
+tlsf::find_suitable_class(size_type size) const noexcept
+{
+    // round up to the next class, so any range in found class is large enough
+    if (size >= sl_count)
+    {
+        auto const msb{ static_cast<unsigned>(std::bit_width(size) - 1) };
+        auto const step{ size_type{ 1 } << (msb - sl_log2) };
+
+        if (size > std::numeric_limits<size_type>::max() - (step - 1))
+        {
+            return std::nullopt;
+        }
+
+        size += step - 1;
+    }
+
+    return first_non_empty_class(class_of(size));
+}
+
+std::optional<tlsf::size_class>
+tlsf::first_non_empty_class(size_class c) const noexcept
+{
+    auto sl_map{ sl_bitmaps[c.fl] & (~std::uint32_t{ 0 } << c.sl) };
+    if (sl_map == 0)
+    {
+        auto const fl_map{ c.fl + 1 < fl_count ? fl_bitmap & (~std::uint64_t{ 0 } << (c.fl + 1)) : 0 };
+        if (fl_map == 0)
+        {
+            return std::nullopt;
+        }
+
+        c.fl = static_cast<unsigned>(std::countr_zero(fl_map));
+        sl_map = sl_bitmaps[c.fl];
+    }
+
+    c.sl = static_cast<unsigned>(std::countr_zero(sl_map));
+
+    return c;
+}
+
+tlsf::node_index_type
+tlsf::find_in_class(size_type const size, size_type const alignment) const noexcept
+{
+    // it's called only when no class is large enough for any of its ranges,
+    // so only a few classes below that one are non-empty
+    for (auto c{ first_non_empty_class(class_of(size)) }; c;)
+    {
+        for (auto n{ free_heads[c->fl][c->sl] }; n != npos; n = nodes[n].next_free)
+        {
+            auto const offset{ nodes[n].offset };
+            auto const aligned_offset{ (offset + alignment - 1) & ~(alignment - 1) };
+
+            if (aligned_offset - offset + size <= nodes[n].size)
+            {
+                return n;
+            }
+        }
+
+        if (c->sl + 1 < sl_count)
+        {
+            c = first_non_empty_class({ .fl = c->fl, .sl = c->sl + 1 });
+        } else if (c->fl + 1 < fl_count)
+        {
+            c = first_non_empty_class({ .fl = c->fl + 1, .sl = 0 });
+        } else
+        {
+            c = std::nullopt;
+        }
+    }
+
+    return npos;
+}
+
+tlsf::node_index_type
+tlsf::make_node()
+{
+    if (!unused_nodes.empty())
+    {
+        auto const n{ unused_nodes.back() };
+        unused_nodes.pop_back();
+        nodes[n] = node{};
+
+        return n;
+    }
+
+    nodes.emplace_back();
+
+    return static_cast<node_index_type>(nodes.size() - 1);
+}
+
+void
+tlsf::release_node(node_index_type const n) noexcept
+{
+    // `unused_nodes` never outgrows `nodes`, it's reserved in advance
+    unused_nodes.push_back(n);
+}
+
+void
+tlsf::insert_free(node_index_type const n) noexcept
+{
+    auto const c{ class_of(nodes[n].size) };
+    auto& head{ free_heads[c.fl][c.sl] };
+
+    nodes[n].free = true;
+    nodes[n].prev_free = npos;
+    nodes[n].next_free = head;
+
+    if (head != npos)
+    {
+        nodes[head].prev_free = n;
+    }
+
+    head = n;
+
+    fl_bitmap |= std::uint64_t{ 1 } << c.fl;
+    sl_bitmaps[c.fl] |= std::uint32_t{ 1 } << c.sl;
+
+    ++free_ranges;
+}
+
+void
+tlsf::remove_free(node_index_type const n) noexcept
+{
+    auto const c{ class_of(nodes[n].size) };
+    auto const prev{ nodes[n].prev_free };
+    auto const next{ nodes[n].next_free };
+
+    if (prev != npos)
+    {
+        nodes[prev].next_free = next;
+    } else
+    {
+        free_heads[c.fl][c.sl] = next;
+    }
+
+    if (next != npos)
+    {
+        nodes[next].prev_free = prev;
+    }
+
+    if (free_heads[c.fl][c.sl] == npos)
+    {
+        sl_bitmaps[c.fl] &= ~(std::uint32_t{ 1 } << c.sl);
+        if (sl_bitmaps[c.fl] == 0)
+        {
+            fl_bitmap &= ~(std::uint64_t{ 1 } << c.fl);
+        }
+    }
+
+    nodes[n].free = false;
+    nodes[n].prev_free = npos;
+    nodes[n].next_free = npos;
+
+    --free_ranges;
+}
+
+tlsf::node_index_type
+tlsf::split(node_index_type const n, size_type const at)
+{
+    assert(at > 0 && at < nodes[n].size);
+
+    // `make_node` may reallocate `nodes`, so no references are taken before it
+    auto const second{ make_node() };
+    unused_nodes.reserve(nodes.size());
+
+    auto const next{ nodes[n].next_physical };
+
+    nodes[second].offset = nodes[n].offset + at;
+    nodes[second].size = nodes[n].size - at;
+    nodes[second].prev_physical = n;
+    nodes[second].next_physical = next;
+
+    nodes[n].size = at;
+    nodes[n].next_physical = second;
+
+    if (next != npos)
+    {
+        nodes[next].prev_physical = second;
+    }
+
+    return second;
+}
+
+void
+tlsf::merge(node_index_type const n, node_index_type const next) noexcept
+{
+    auto const after{ nodes[next].next_physical };
+
+    nodes[n].size += nodes[next].size;
+    nodes[n].next_physical = after;
+
+    if (after != npos)
+    {
+        nodes[after].prev_physical = n;
+    }
+
+    release_node(next);
+}
+
+} // namespace orbi::detail
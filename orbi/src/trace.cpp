@@ -0,0 +1,261 @@
+#include <orbi/trace.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace orbi::trace
+{
+
+namespace
+{
+
+#ifdef ORBI_TRACE
+
+std::string
+escape(std::string_view const str)
+{
+    std::string result;
+    result.reserve(str.size());
+
+    for (auto const ch : str)
+    {
+        if (ch == '"' || ch == '\\')
+        {
+            result += '\\';
+        }
+
+        result += ch;
+    }
+
+    return result;
+}
+
+/*
+    fields are atomic only to make concurrent export well defined,
+    relaxed stores compile to plain stores
+
+    `sequence` is seqlock of the slot: odd while the event with index `sequence / 2` is written,
+    `2 * (index + 1)` once it's complete, so export skips events overwritten while they are read
+*/
+struct event
+{
+    std::atomic<std::uint64_t> sequence{ 0 };
+    // ring is reused by other thread after its thread exits, so each event remembers its own
+    std::atomic<std::uint32_t> thread_id{ 0 };
+    std::atomic<char const*> name{ nullptr };
+    std::atomic<std::uint64_t> begin_ns{ 0 };
+    std::atomic<std::uint64_t> end_ns{ 0 };
+};
+
+// written by one thread at a time
+struct ring
+{
+    std::uint32_t thread_id{ 0 };
+    // set by registry, when thread exits, ring is given to the next new thread
+    bool free{ false };
+    std::atomic<std::uint64_t> written{ 0 };
+    // events before it are dropped by `clear`
+    std::atomic<std::uint64_t> cleared{ 0 };
+    std::array<event, ring_capacity> events;
+};
+
+/*
+    rings stay alive after their threads exit, so their events can still be exported,
+    new thread takes ring of exited one, so number of rings is bounded by number of concurrent threads
+*/
+struct registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ring>> rings;
+    std::uint32_t next_thread_id{ 1 };
+};
+
+registry&
+get_registry()
+{
+    static registry r;
+    return r;
+}
+
+// ring of current thread, given back to registry on thread exit
+struct ring_owner
+{
+    ring_owner()
+    {
+        auto& reg{ get_registry() };
+        std::scoped_lock const lock{ reg.mutex };
+
+        auto const it{ std::ranges::find_if(reg.rings, [](auto const& r) { return r->free; }) };
+        if (it != end(reg.rings))
+        {
+            // events of exited thread are kept until they are overwritten
+            owned = it->get();
+        } else
+        {
+            owned = reg.rings.emplace_back(std::make_unique<ring>()).get();
+        }
+
+        owned->thread_id = reg.next_thread_id++;
+        owned->free = false;
+    }
+
+    ~ring_owner()
+    {
+        auto& reg{ get_registry() };
+        std::scoped_lock const lock{ reg.mutex };
+
+        owned->free = true;
+    }
+
+    ring_owner(ring_owner const&) = delete;
+    ring_owner& operator=(ring_owner const&) = delete;
+
+    ring* owned{ nullptr };
+};
+
+ring&
+local_ring()
+{
+    thread_local ring_owner const local;
+
+    return *local.owned;
+}
+
+std::uint64_t
+now_ns()
+{
+    using namespace std::chrono;
+
+    static auto const epoch{ steady_clock::now() };
+    return static_cast<std::uint64_t>(duration_cast<nanoseconds>(steady_clock::now() - epoch).count());
+}
+
+void
+record(char const* const name, std::uint64_t const begin_ns, std::uint64_t const end_ns)
+{
+    auto& r{ local_ring() };
+    auto const index{ r.written.load(std::memory_order_relaxed) };
+    auto& e{ r.events[index % ring_capacity] };
+
+    e.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    e.thread_id.store(r.thread_id, std::memory_order_relaxed);
+    e.name.store(name, std::memory_order_relaxed);
+    e.begin_ns.store(begin_ns, std::memory_order_relaxed);
+    e.end_ns.store(end_ns, std::memory_order_relaxed);
+
+    e.sequence.store(2 * (index + 1), std::memory_order_release);
+    r.written.store(index + 1, std::memory_order_release);
+}
+
+#endif
+
+} // namespace
+
+#ifdef ORBI_TRACE
+
+scope::scope(char const* const name) noexcept
+    : event_name{ name }
+    , begin_ns{ now_ns() }
+{
+}
+
+scope::~scope()
+{
+    record(event_name, begin_ns, now_ns());
+}
+
+#else
+
+scope::scope(char const* const name) noexcept
+    : event_name{ name }
+    , begin_ns{ 0 }
+{
+}
+
+scope::~scope() = default;
+
+#endif
+
+void
+write_chrome_json(std::ostream& out)
+{
+    out << R"({"displayTimeUnit":"ms","traceEvents":[)";
+
+#ifdef ORBI_TRACE
+    auto& reg{ get_registry() };
+    std::scoped_lock const lock{ reg.mutex };
+
+    bool first{ true };
+    for (auto const& r : reg.rings)
+    {
+        auto const written{ r->written.load(std::memory_order_acquire) };
+        auto const oldest{ written > ring_capacity ? written - ring_capacity : 0 };
+
+        for (auto i{ std::max(oldest, r->cleared.load()) }; i < written; ++i)
+        {
+            auto const& e{ r->events[i % ring_capacity] };
+
+            // owner thread may overwrite the slot meanwhile, then event is lost rather than torn
+            auto const sequence{ e.sequence.load(std::memory_order_acquire) };
+            auto const thread_id{ e.thread_id.load(std::memory_order_relaxed) };
+            auto const* const name{ e.name.load(std::memory_order_relaxed) };
+            auto const begin_ns{ e.begin_ns.load(std::memory_order_relaxed) };
+            auto const end_ns{ e.end_ns.load(std::memory_order_relaxed) };
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence != 2 * (i + 1) || e.sequence.load(std::memory_order_relaxed) != sequence)
+            {
+                continue;
+            }
+
+            out << (first ? "" : ",")
+                << std::format(R"({{"name":"{}","cat":"orbi","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                               escape(name), thread_id, static_cast<double>(begin_ns) / 1e3,
+                               static_cast<double>(end_ns - begin_ns) / 1e3);
+            first = false;
+        }
+    }
+#endif
+
+    out << "]}\n";
+}
+
+bool
+write_chrome_json(std::filesystem::path const& path)
+{
+    std::ofstream file{ path };
+    if (!file)
+    {
+        return false;
+    }
+
+    write_chrome_json(file);
+
+    return static_cast<bool>(file.flush());
+}
+
+void
+clear() noexcept
+{
+#ifdef ORBI_TRACE
+    auto& reg{ get_registry() };
+    std::scoped_lock const lock{ reg.mutex };
+
+    for (auto const& r : reg.rings)
+    {
+        r->cleared.store(r->written.load());
+    }
+#endif
+}
+
+} // namespace orbi::trace
@@ -0,0 +1,560 @@
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/gpu_allocator.hpp>
+#include <orbi/renderer.hpp>
+#include <orbi/timeline.hpp>
+#include <orbi/trace.hpp>
+#include <orbi/uploader.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace orbi
+{
+
+namespace
+{
+
+std::uint64_t
+align_up(std::uint64_t const value, std::uint64_t const alignment) noexcept
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// moves finished batches to `free`, so their part of ring can be reused
+// @return `true` if any space of ring was freed
+bool
+reclaim(uploader::impl const& u, uploader::impl::state& s)
+{
+    auto const tail{ s.tail };
+
+    while (!s.in_flight.empty() && u.done->reached(s.in_flight.front().value))
+    {
+        auto& b{ s.in_flight.front() };
+
+        s.tail = b.ring_end;
+        b.command_pool.reset();
+        b.buffer_copies.clear();
+        b.image_copies.clear();
+
+        s.free.push_back(std::move(b));
+        s.in_flight.pop_front();
+    }
+
+    // ring is empty, so the next allocation may start at its beginning
+    if (s.in_flight.empty() && s.pending.value == 0)
+    {
+        s.head = align_up(s.head, s.stats.ring_size);
+        s.tail = s.head;
+    }
+
+    return s.tail != tail;
+}
+
+// batch which gets the next upload, command buffer of finished one is reused if possible
+uploader::impl::batch&
+pending(uploader::impl const& u, uploader::impl::state& s)
+{
+    if (s.pending.value != 0)
+    {
+        return s.pending;
+    }
+
+    if (!s.free.empty())
+    {
+        s.pending = std::move(s.free.back());
+        s.free.pop_back();
+    } else
+    {
+        auto const& vk_device{ u.dev->vk_device };
+
+        s.pending.command_pool = vk::raii::CommandPool{
+            vk_device, vk::CommandPoolCreateInfo{ .flags = vk::CommandPoolCreateFlagBits::eTransient,
+                                                  .queueFamilyIndex = u.dev->transfer_queue.family_index }
+        };
+
+        s.pending.command_buffer = std::move(vk_device
+                                                 .allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+                                                     .commandPool = s.pending.command_pool,
+                                                     .level = vk::CommandBufferLevel::ePrimary,
+                                                     .commandBufferCount = 1 })
+                                                 .front());
+
+        u.dev->set_name(*s.pending.command_buffer, "orbi::uploader batch {}", s.free.size() + s.in_flight.size());
+    }
+
+    s.pending.value = u.done->advance();
+
+    return s.pending;
+}
+
+void
+record_buffer_copies(uploader::impl const& u, uploader::impl::state& s, uploader::impl::batch& b,
+                     std::vector<vk::BufferMemoryBarrier>& releases)
+{
+    auto& copies{ b.buffer_copies };
+
+    // copies to the same buffer become regions of one command
+    std::ranges::stable_sort(copies, {}, [](auto const& c) { return static_cast<VkBuffer>(c.dst); });
+
+    std::vector<vk::BufferCopy> regions;
+    for (auto first{ begin(copies) }; first != end(copies);)
+    {
+        auto const last{ std::find_if(first, end(copies), [&](auto const& c) { return c.dst != first->dst; }) };
+
+        regions.clear();
+        std::transform(first, last, std::back_inserter(regions), [](auto const& c) { return c.region; });
+
+        b.command_buffer.copyBuffer(u.ring, first->dst, regions);
+        ++s.stats.copy_command_count;
+
+        first = last;
+    }
+
+    for (auto const& c : copies)
+    {
+        auto const transfer{ device::impl::make_ownership_transfer(
+            u.dev->transfer_queue, u.dev->graphics_queue, c.dst, vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eMemoryRead, c.region.dstOffset, c.region.size) };
+
+        // otherwise semaphore, which the consumer waits for, makes writes visible
+        if (transfer.required())
+        {
+            releases.push_back(transfer.release);
+            s.buffer_acquires.push_back(transfer);
+        }
+    }
+}
+
+void
+record_image_copies(uploader::impl const& u, uploader::impl::state& s, uploader::impl::batch& b,
+                    std::vector<vk::ImageMemoryBarrier>& releases, std::vector<vk::ImageMemoryBarrier>& transitions)
+{
+    auto& copies{ b.image_copies };
+    if (copies.empty())
+    {
+        return;
+    }
+
+    auto const range_of = [](vk::ImageSubresourceLayers const& l)
+    {
+        return vk::ImageSubresourceRange{ .aspectMask = l.aspectMask,
+                                          .baseMipLevel = l.mipLevel,
+                                          .levelCount = 1,
+                                          .baseArrayLayer = l.baseArrayLayer,
+                                          .layerCount = l.layerCount };
+    };
+
+    // several regions of one subresource get one transition, otherwise the later one discards earlier copies
+    struct subresource
+    {
+        vk::Image image;
+        vk::ImageSubresourceRange range;
+        vk::ImageLayout final_layout;
+    };
+
+    std::vector<subresource> subresources;
+    for (auto const& c : copies)
+    {
+        auto const range{ range_of(c.region.imageSubresource) };
+        auto const it{ std::ranges::find_if(subresources,
+                                            [&](auto const& r) { return r.image == c.dst && r.range == range; }) };
+
+        if (it == end(subresources))
+        {
+            subresources.push_back({ .image = c.dst, .range = range, .final_layout = c.final_layout });
+        } else
+        {
+            // the last upload decides
+            it->final_layout = c.final_layout;
+        }
+    }
+
+    std::vector<vk::ImageMemoryBarrier> to_transfer;
+    to_transfer.reserve(subresources.size());
+    for (auto const& r : subresources)
+    {
+        to_transfer.push_back({ .srcAccessMask = {},
+                                .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+                                .oldLayout = vk::ImageLayout::eUndefined,
+                                .newLayout = vk::ImageLayout::eTransferDstOptimal,
+                                .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                .image = r.image,
+                                .subresourceRange = r.range });
+    }
+
+    b.command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, {},
+                                     {}, {}, to_transfer);
+
+    std::ranges::stable_sort(copies, {}, [](auto const& c) { return static_cast<VkImage>(c.dst); });
+
+    std::vector<vk::BufferImageCopy> regions;
+    for (auto first{ begin(copies) }; first != end(copies);)
+    {
+        auto const last{ std::find_if(first, end(copies), [&](auto const& c) { return c.dst != first->dst; }) };
+
+        regions.clear();
+        std::transform(first, last, std::back_inserter(regions), [](auto const& c) { return c.region; });
+
+        b.command_buffer.copyBufferToImage(u.ring, first->dst, vk::ImageLayout::eTransferDstOptimal, regions);
+        ++s.stats.copy_command_count;
+
+        first = last;
+    }
+
+    for (auto const& r : subresources)
+    {
+        auto const transfer{ device::impl::make_ownership_transfer(
+            u.dev->transfer_queue, u.dev->graphics_queue, r.image, r.range, vk::ImageLayout::eTransferDstOptimal,
+            r.final_layout, vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead) };
+
+        if (transfer.required())
+        {
+            releases.push_back(transfer.release);
+            s.image_acquires.push_back(transfer);
+        } else
+        {
+            transitions.push_back(transfer.acquire);
+        }
+    }
+}
+
+// records and submits `s.pending`
+void
+submit(uploader::impl const& u, uploader::impl::state& s)
+{
+    ORBI_TRACE_SCOPE("uploader::submit");
+
+    auto& b{ s.pending };
+    auto const& command_buffer{ b.command_buffer };
+
+    command_buffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    u.dev->begin_label(command_buffer, "orbi::uploader::submit");
+
+    std::vector<vk::BufferMemoryBarrier> buffer_releases;
+    std::vector<vk::ImageMemoryBarrier> image_releases;
+    std::vector<vk::ImageMemoryBarrier> image_transitions;
+
+    record_buffer_copies(u, s, b, buffer_releases);
+    record_image_copies(u, s, b, image_releases, image_transitions);
+
+    if (!buffer_releases.empty() || !image_releases.empty())
+    {
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
+                                       {}, {}, buffer_releases, image_releases);
+    }
+
+    if (!image_transitions.empty())
+    {
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands,
+                                       {}, {}, {}, image_transitions);
+    }
+
+    u.dev->end_label(command_buffer);
+    command_buffer.end();
+
+    vk::CommandBufferSubmitInfo const command_buffer_info{ .commandBuffer = command_buffer };
+    auto const signal_info{ u.done->submit_info(b.value) };
+
+    u.dev->transfer_queue.vk_queue.submit2(vk::SubmitInfo2{ .commandBufferInfoCount = 1,
+                                                            .pCommandBufferInfos = &command_buffer_info,
+                                                            .signalSemaphoreInfoCount = 1,
+                                                            .pSignalSemaphoreInfos = &signal_info });
+
+    ++s.stats.batch_count;
+    s.submitted = b.value;
+
+    s.in_flight.push_back(std::move(b));
+    s.pending = {};
+}
+
+/*
+    @param alignment of offset in ring, ring size doesn't have to be multiple of it
+    @return position of `size` bytes in ring, blocks while ring is full
+*/
+std::uint64_t
+allocate(uploader::impl const& u, uploader::impl::state& s, vk::DeviceSize const size,
+         vk::DeviceSize const alignment)
+{
+    auto const ring_size{ s.stats.ring_size };
+    if (size > ring_size)
+    {
+        throw uploader::error{ "uploader::upload: {} bytes don't fit into ring of {} bytes", size, ring_size };
+    }
+
+    while (true)
+    {
+        auto const offset{ s.head % ring_size };
+        auto const aligned_offset{ align_up(offset, alignment) };
+        auto position{ s.head - offset + aligned_offset };
+
+        // copy source must be contiguous, so allocation doesn't wrap around end of ring, offset `0` fits any alignment
+        if (aligned_offset + size > ring_size)
+        {
+            position = s.head - offset + ring_size;
+        }
+
+        if (position + size - s.tail <= ring_size)
+        {
+            s.head = position + size;
+            s.stats.peak_ring_usage = std::max(s.stats.peak_ring_usage, s.head - s.tail);
+
+            return position;
+        }
+
+        if (reclaim(u, s))
+        {
+            continue;
+        }
+
+        // pending batch holds the rest of ring, empty ring always has enough space
+        if (s.in_flight.empty())
+        {
+            assert(s.pending.value != 0);
+            submit(u, s);
+        }
+
+        ORBI_TRACE_SCOPE("uploader::stall");
+
+        ++s.stats.stall_count;
+        u.done->wait(s.in_flight.front().value);
+    }
+}
+
+} // namespace
+
+uploader::uploader(device const& dev, vk::DeviceSize const ring_size)
+try
+{
+    assert(ring_size > 0);
+
+    auto const& dev_impl{ device::impl::from_device(dev) };
+    auto const& vk_device{ dev_impl.vk_device };
+
+    data->dev = &dev_impl;
+
+    data->alignment = std::max<vk::DeviceSize>(
+        1, dev_impl.vk_physical_device.getProperties().limits.optimalBufferCopyOffsetAlignment);
+
+    auto const size{ align_up(ring_size, data->alignment) };
+
+    data->ring = vk::raii::Buffer{ vk_device, vk::BufferCreateInfo{ .size = size,
+                                                                    .usage = vk::BufferUsageFlagBits::eTransferSrc } };
+
+    data->ring_allocation = dev_impl.allocator->allocate(
+        { .requirements = data->ring.getMemoryRequirements(), .usage = memory_usage::upload });
+    data->ring.bindMemory(data->ring_allocation.memory, data->ring_allocation.offset);
+
+    dev_impl.set_name(*data->ring, "orbi::uploader ring");
+
+    data->done = std::make_unique<timeline>(dev);
+    data->shared = std::make_unique<impl::state>();
+    data->shared->stats.ring_size = size;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "uploader::uploader: Internal call to vulkan failed" });
+}
+
+uploader::~uploader()
+{
+    if (!data->shared)
+    {
+        return;
+    }
+
+    try
+    {
+        data->done->wait(data->shared->submitted);
+
+        // batch, which was never flushed, has reserved value too, `done` waits for it on destruction
+        if (data->shared->pending.value != 0)
+        {
+            data->done->signal(data->shared->pending.value);
+        }
+    }
+    catch (...)
+    {
+        // device is lost, nothing is executed anymore
+    }
+
+    data->ring.clear();
+    data->dev->allocator->free(data->ring_allocation);
+}
+
+uploader::uploader(uploader&& other) noexcept
+    : data(std::move(*other.data))
+{
+}
+
+uploader&
+uploader::operator=(uploader other)
+{
+    swap(*this, other);
+
+    return *this;
+}
+
+void
+swap(uploader& l, uploader& r) noexcept
+{
+    using std::swap;
+
+    swap(*l.data, *r.data);
+}
+
+timeline::value_type
+uploader::upload(vk::Buffer const dst, vk::DeviceSize const offset, std::span<std::byte const> const bytes)
+try
+{
+    assert(!bytes.empty());
+
+    auto& s{ *data->shared };
+    std::scoped_lock const lock{ s.mutex };
+
+    auto const position{ allocate(*data, s, bytes.size(), data->alignment) };
+    auto const ring_offset{ position % s.stats.ring_size };
+    std::memcpy(data->ring_allocation.mapped + ring_offset, bytes.data(), bytes.size());
+
+    auto& b{ pending(*data, s) };
+    b.buffer_copies.push_back({ .dst = dst,
+                                .region = { .srcOffset = ring_offset, .dstOffset = offset, .size = bytes.size() } });
+    b.ring_end = s.head;
+
+    s.stats.bytes_uploaded += bytes.size();
+    ++s.stats.upload_count;
+
+    return b.value;
+}
+catch (uploader::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "uploader::upload: Internal call to vulkan failed" });
+}
+
+timeline::value_type
+uploader::upload(vk::Image const dst, image_upload_region const& region, std::span<std::byte const> const bytes,
+                 vk::ImageLayout const final_layout)
+try
+{
+    assert(!bytes.empty());
+    assert(region.format != vk::Format::eUndefined);
+
+    // `bufferOffset` must be multiple of texel block size (e.g. 12 bytes of RGB32) and of 4
+    auto const alignment{ std::lcm(std::lcm(vk::DeviceSize{ vk::blockSize(region.format) }, vk::DeviceSize{ 4 }),
+                                   data->alignment) };
+
+    auto& s{ *data->shared };
+    std::scoped_lock const lock{ s.mutex };
+
+    auto const position{ allocate(*data, s, bytes.size(), alignment) };
+    auto const ring_offset{ position % s.stats.ring_size };
+    std::memcpy(data->ring_allocation.mapped + ring_offset, bytes.data(), bytes.size());
+
+    auto& b{ pending(*data, s) };
+    b.image_copies.push_back({ .dst = dst,
+                               .region = { .bufferOffset = ring_offset,
+                                           .imageSubresource = region.subresource,
+                                           .imageOffset = region.offset,
+                                           .imageExtent = region.extent },
+                               .final_layout = final_layout });
+    b.ring_end = s.head;
+
+    s.stats.bytes_uploaded += bytes.size();
+    ++s.stats.upload_count;
+
+    return b.value;
+}
+catch (uploader::error const&)
+{
+    throw;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "uploader::upload: Internal call to vulkan failed" });
+}
+
+timeline::value_type
+uploader::flush()
+try
+{
+    auto& s{ *data->shared };
+    std::scoped_lock const lock{ s.mutex };
+
+    if (s.pending.value != 0)
+    {
+        submit(*data, s);
+    }
+
+    reclaim(*data, s);
+
+    return s.submitted;
+}
+catch (...)
+{
+    std::throw_with_nested(error{ "uploader::flush: Internal call to vulkan failed" });
+}
+
+void
+uploader::acquire(renderer& r, vk::raii::CommandBuffer const& command_buffer)
+{
+    auto& s{ *data->shared };
+    std::scoped_lock const lock{ s.mutex };
+
+    if (s.submitted > s.acquired)
+    {
+        r.wait_for(*data->done, s.submitted);
+        s.acquired = s.submitted;
+    }
+
+    if (s.buffer_acquires.empty() && s.image_acquires.empty())
+    {
+        return;
+    }
+
+    std::vector<vk::BufferMemoryBarrier> buffer_barriers;
+    buffer_barriers.reserve(s.buffer_acquires.size());
+    std::ranges::transform(s.buffer_acquires, std::back_inserter(buffer_barriers),
+                           [](auto const& t) { return t.acquire; });
+
+    std::vector<vk::ImageMemoryBarrier> image_barriers;
+    image_barriers.reserve(s.image_acquires.size());
+    std::ranges::transform(s.image_acquires, std::back_inserter(image_barriers),
+                           [](auto const& t) { return t.acquire; });
+
+    // execution dependency with release is provided by semaphore
+    command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eAllCommands, {},
+                                   {}, buffer_barriers, image_barriers);
+
+    s.buffer_acquires.clear();
+    s.image_acquires.clear();
+}
+
+timeline const&
+uploader::completion() const noexcept
+{
+    return *data->done;
+}
+
+upload_stats
+uploader::stats() const
+{
+    std::scoped_lock const lock{ data->shared->mutex };
+
+    return data->shared->stats;
+}
+
+} // namespace orbi
@@ -2,6 +2,7 @@
 #include <orbi/detail/impl.hpp>
 #include <orbi/detail/util.hpp>
 #include <orbi/device.hpp>
+#include <orbi/trace.hpp>
 #include <orbi/window.hpp>
 
 #include <SDL3/SDL_video.h>
@@ -16,6 +17,13 @@ namespace orbi
 
 window::window(context const& ctx)
 {
+    ORBI_TRACE_SCOPE("window::window");
+
+    if (ctx.headless())
+    {
+        throw error{ "window::window: context is headless, SDL video isn't initialized" };
+    }
+
     data->sdl_window = SDL_CreateWindow("default window name", 500, 500, SDL_WINDOW_VULKAN);
     if (!data->sdl_window)
     {
@@ -0,0 +1,84 @@
+/*
+    packs files into archive read by `orbi::asset_archive`
+
+    usage: orbi_pack [--zstd] --output <archive> <name>=<file>...
+*/
+
+#include <orbi/detail/archive.hpp>
+
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+void
+print_nested(std::exception const& e)
+{
+    std::cerr << "orbi_pack: " << e.what() << '\n';
+
+    try
+    {
+        std::rethrow_if_nested(e);
+    }
+    catch (std::exception const& nested)
+    {
+        print_nested(nested);
+    }
+    catch (...)
+    {
+        std::cerr << "orbi_pack: unknown exception\n";
+    }
+}
+
+} // namespace
+
+int
+main(int const argc, char const* const* const argv)
+try
+{
+    std::vector<std::string_view> const args(argv + 1, argv + argc);
+
+    std::filesystem::path output;
+    bool compress{ false };
+    std::vector<orbi::detail::archive_input> inputs;
+
+    for (std::size_t i{ 0 }; i < args.size(); ++i)
+    {
+        if (args[i] == "--zstd")
+        {
+            compress = true;
+        } else if (args[i] == "--output" && i + 1 < args.size())
+        {
+            output = args[++i];
+        } else if (auto const separator{ args[i].find('=') }; separator != std::string_view::npos && separator > 0)
+        {
+            inputs.push_back({ .name = std::string{ args[i].substr(0, separator) },
+                               .path = args[i].substr(separator + 1) });
+        } else
+        {
+            std::cerr << "orbi_pack: unexpected argument '" << args[i] << "'\n"
+                      << "usage: orbi_pack [--zstd] --output <archive> <name>=<file>...\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (output.empty())
+    {
+        std::cerr << "usage: orbi_pack [--zstd] --output <archive> <name>=<file>...\n";
+        return EXIT_FAILURE;
+    }
+
+    orbi::detail::write_archive(output, inputs, compress);
+
+    return EXIT_SUCCESS;
+}
+catch (std::exception const& e)
+{
+    print_nested(e);
+    return EXIT_FAILURE;
+}
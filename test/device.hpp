@@ -0,0 +1,34 @@
+#pragma once
+
+#include <doctest/doctest.h>
+
+#include <orbi/device.hpp>
+
+#include <optional>
+
+namespace test
+{
+
+/*
+    creates device for test, which has nothing to test without it
+
+    @return device or nothing if there is no suitable device, which is reported by test message
+*/
+template <typename... Args>
+std::optional<orbi::device>
+make_device(Args const&... args)
+{
+    std::optional<orbi::device> device;
+    try
+    {
+        device.emplace(args...);
+    }
+    catch (orbi::device::error const& e)
+    {
+        MESSAGE("there is no suitable device, test is skipped: " << e.what());
+    }
+
+    return device;
+}
+
+} // namespace test
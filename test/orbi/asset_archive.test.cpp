@@ -0,0 +1,120 @@
+#include <doctest/doctest.h>
+
+#include <orbi/asset_archive.hpp>
+#include <orbi/asset_source.hpp>
+#include <orbi/detail/archive.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("asset_archive")
+    {
+        auto const directory{ std::filesystem::temp_directory_path() / "orbi_asset_archive_test" };
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        std::string const big(1000, 'x');
+        std::ofstream{ directory / "a.bin", std::ios::binary } << "abcdefgh";
+        std::ofstream{ directory / "big.bin", std::ios::binary } << big;
+        std::ofstream{ directory / "empty.bin", std::ios::binary };
+
+        // unsorted on purpose, packer sorts them
+        std::vector<orbi::detail::archive_input> const inputs{
+            { .name = "shaders/big.bin", .path = directory / "big.bin" },
+            { .name = "a", .path = directory / "a.bin" },
+            { .name = "empty", .path = directory / "empty.bin" },
+        };
+
+        orbi::detail::write_archive(directory / "assets.pak", inputs, false);
+
+        orbi::asset_source const source{ directory };
+        orbi::asset_archive const archive{ source, "assets.pak" };
+
+        auto const text = [](orbi::asset const& a)
+        { return std::string_view{ reinterpret_cast<char const*>(a.bytes.data()), a.bytes.size() }; };
+
+        CHECK(archive.size() == 3);
+        CHECK(archive.contains("a"));
+        CHECK(archive.contains("shaders/big.bin"));
+        CHECK(!archive.contains("shaders"));
+
+        SUBCASE("entries are aligned views into archive")
+        {
+            auto const a{ archive.open("a") };
+            CHECK(text(a) == "abcdefgh");
+            CHECK(reinterpret_cast<std::uintptr_t>(a.bytes.data()) % orbi::detail::archive_alignment == 0);
+            CHECK(a.words().size() == 2);
+
+            auto const b{ archive.open("shaders/big.bin") };
+            CHECK(text(b) == big);
+            CHECK(b.storage == a.storage);
+
+            CHECK(archive.open("empty").bytes.empty());
+        }
+
+        SUBCASE("entries outlive archive")
+        {
+            orbi::asset a;
+            {
+                orbi::asset_archive const other{ source, "assets.pak" };
+                a = other.open("a");
+            }
+            CHECK(text(a) == "abcdefgh");
+        }
+
+        SUBCASE("missing entry")
+        {
+            CHECK_THROWS_AS(archive.open("b"), orbi::asset_archive::error);
+        }
+
+        SUBCASE("not an archive")
+        {
+            CHECK_THROWS_AS(orbi::asset_archive(source, "a.bin"), orbi::asset_archive::error);
+            CHECK_THROWS_AS(orbi::asset_archive(source, "missing.pak"), orbi::asset_archive::error);
+        }
+
+        SUBCASE("truncated archive")
+        {
+            std::filesystem::copy_file(directory / "assets.pak", directory / "truncated.pak");
+            std::filesystem::resize_file(directory / "truncated.pak",
+                                         std::filesystem::file_size(directory / "assets.pak") - 1);
+
+            CHECK_THROWS_AS(orbi::asset_archive(source, "truncated.pak"), orbi::asset_archive::error);
+        }
+
+        SUBCASE("names are unique")
+        {
+            std::vector<orbi::detail::archive_input> const duplicates{
+                { .name = "a", .path = directory / "a.bin" },
+                { .name = "a", .path = directory / "big.bin" },
+            };
+
+            CHECK_THROWS_AS(orbi::detail::write_archive(directory / "duplicates.pak", duplicates, false),
+                            orbi::detail::archive_error);
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+
+    TEST_CASE("asset_archive opens archive packed by orbi_add_archive")
+    {
+        std::filesystem::path const path{ ORBI_TEST_ARCHIVE };
+
+        orbi::asset_source const source{ path.parent_path() };
+        orbi::asset_archive const archive{ source, path.filename() };
+
+        // GLSL is compiled to SPIR-V and `.spv` is appended to its name
+        CHECK(archive.size() == 1);
+        REQUIRE(archive.contains("triangle.vert.spv"));
+
+        auto const spirv{ archive.open("triangle.vert.spv").words() };
+        REQUIRE(!spirv.empty());
+        CHECK(spirv[0] == 0x07230203);
+    }
+}
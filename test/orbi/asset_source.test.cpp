@@ -0,0 +1,66 @@
+#include <doctest/doctest.h>
+
+#include <orbi/asset_source.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("asset_source")
+    {
+        auto const directory{ std::filesystem::temp_directory_path() / "orbi_asset_source_test" };
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        constexpr std::string_view content{ "abcdefgh" };
+        std::ofstream{ directory / "asset.bin", std::ios::binary } << content;
+        std::ofstream{ directory / "empty.bin", std::ios::binary };
+
+        orbi::asset_source const source{ directory, 2 };
+
+        auto const check = [&](orbi::asset const& a)
+        {
+            REQUIRE(a.bytes.size() == content.size());
+            CHECK(std::string_view{ reinterpret_cast<char const*>(a.bytes.data()), a.bytes.size() } == content);
+            CHECK(a.words().size() == content.size() / 4);
+            CHECK(a.storage);
+        };
+
+        SUBCASE("open")
+        {
+            check(source.open("asset.bin"));
+        }
+
+        SUBCASE("read")
+        {
+            check(source.read("asset.bin").get());
+        }
+
+        SUBCASE("bytes outlive source")
+        {
+            orbi::asset a;
+            {
+                orbi::asset_source const other{ directory };
+                a = other.open("asset.bin");
+            }
+            check(a);
+        }
+
+        SUBCASE("empty")
+        {
+            CHECK(source.open("empty.bin").bytes.empty());
+            CHECK(source.read("empty.bin").get().bytes.empty());
+        }
+
+        SUBCASE("missing")
+        {
+            CHECK_THROWS_AS(source.open("missing.bin"), orbi::asset_source::error);
+            CHECK_THROWS_AS(source.read("missing.bin").get(), orbi::asset_source::error);
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+}
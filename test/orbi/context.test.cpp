@@ -2,6 +2,7 @@
 
 #include <orbi/context.hpp>
 #include <orbi/detail/util.hpp>
+#include <orbi/window.hpp>
 
 TEST_SUITE("orbi")
 {
@@ -20,4 +21,33 @@ TEST_SUITE("orbi")
             REQUIRE(false);
         }
     }
+
+    TEST_CASE("context::context headless")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+        CHECK(ctx.headless());
+
+        // there is no SDL video, so there is nothing to create window with
+        CHECK_THROWS_AS(orbi::window{ ctx }, orbi::window::error);
+    }
+
+    TEST_CASE("context::context instrumentation")
+    {
+        for (auto const level : { orbi::instrumentation::none, orbi::instrumentation::markers })
+        {
+            orbi::context const ctx{ {}, { .headless = true, .instrumentation_level = level } };
+            CHECK(ctx.instrumentation_level() == level);
+        }
+
+        // validation layer may be not installed, then it's reported by documented exception
+        try
+        {
+            orbi::context const ctx{ {},
+                                     { .headless = true, .instrumentation_level = orbi::instrumentation::validation } };
+            CHECK(ctx.instrumentation_level() == orbi::instrumentation::validation);
+        }
+        catch (orbi::context::error const&)
+        {
+        }
+    }
 }
@@ -0,0 +1,138 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/deletion_queue.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/timeline.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace
+{
+
+// sets flag on destruction, moved-from instance doesn't
+struct resource
+{
+    explicit resource(bool& f)
+        : destroyed{ &f }
+    {
+    }
+
+    resource(resource&& other) noexcept
+        : destroyed{ std::exchange(other.destroyed, nullptr) }
+    {
+    }
+
+    resource& operator=(resource&&) = delete;
+
+    ~resource()
+    {
+        if (destroyed)
+        {
+            *destroyed = true;
+        }
+    }
+
+    bool* destroyed{ nullptr };
+};
+
+} // namespace
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("deletion_queue")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        auto device{ test::make_device(ctx) };
+        if (!device)
+        {
+            return;
+        }
+
+        auto& queue{ device->deletion() };
+        CHECK(queue.size() == 0);
+
+        SUBCASE("resource is destroyed after its value is reached")
+        {
+            orbi::timeline const t{ *device };
+
+            bool first{ false };
+            bool second{ false };
+            queue.push(t, 1, resource{ first });
+            queue.push(t, 2, resource{ second });
+            CHECK(queue.size() == 2);
+
+            CHECK(queue.collect() == 0);
+            CHECK_FALSE(first);
+
+            t.signal(1);
+            CHECK(queue.collect() == 1);
+            CHECK(first);
+            CHECK_FALSE(second);
+
+            t.signal(2);
+            CHECK(queue.collect() == 1);
+            CHECK(second);
+            CHECK(queue.size() == 0);
+        }
+
+        SUBCASE("destroyed timeline releases resources after its values are reached")
+        {
+            orbi::timeline const gate{ *device };
+
+            bool destroyed{ false };
+            std::jthread signaler;
+            {
+                orbi::timeline const t{ *device };
+                auto const value{ t.advance() };
+                queue.push(t, value, resource{ destroyed });
+
+                // value of `t` is signaled by gpu only after `gate` is signaled by cpu
+                auto const wait_info{ gate.submit_info(1) };
+                auto const signal_info{ t.submit_info(value) };
+                orbi::device::impl::from_device(*device).graphics_queue.vk_queue.submit2(
+                    vk::SubmitInfo2{ .waitSemaphoreInfoCount = 1,
+                                     .pWaitSemaphoreInfos = &wait_info,
+                                     .signalSemaphoreInfoCount = 1,
+                                     .pSignalSemaphoreInfos = &signal_info });
+
+                signaler = std::jthread{ [&]
+                                         {
+                                             std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+                                             gate.signal(1);
+                                         } };
+
+                CHECK(queue.collect() == 0);
+                CHECK_FALSE(destroyed);
+            }
+
+            // destructor of `t` waited for its value, so `gate` is already signaled
+            CHECK(gate.completed() >= 1);
+            CHECK(queue.collect() == 1);
+            CHECK(destroyed);
+        }
+
+        SUBCASE("flush waits for values")
+        {
+            orbi::timeline const t{ *device };
+
+            bool destroyed{ false };
+            queue.push(t, 1, resource{ destroyed });
+
+            std::jthread const signaler{ [&] { t.signal(1); } };
+            queue.flush();
+
+            CHECK(destroyed);
+            CHECK(queue.size() == 0);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/descriptor_heap.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <utility>
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("descriptor_heap")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        auto device{ test::make_device(ctx, orbi::device_options{ .bindless = true }) };
+        if (!device)
+        {
+            return;
+        }
+
+        CHECK(device->bindless());
+        CHECK(device->descriptors().set());
+
+        orbi::descriptor_heap heap{ *device, { .sampled_images = 4, .storage_buffers = 4, .samplers = 2 } };
+        CHECK(heap.set());
+        CHECK(heap.set_layout());
+        CHECK(heap.pipeline_layout());
+        CHECK(heap.capacity().samplers == 2);
+
+        vk::raii::Sampler const sampler{ orbi::device::impl::from_device(*device).vk_device, vk::SamplerCreateInfo{} };
+
+        auto const first{ heap.add(*sampler) };
+        auto const second{ heap.add(*sampler) };
+        REQUIRE(first);
+        REQUIRE(second);
+        CHECK(first.index != second.index);
+
+        SUBCASE("full heap throws")
+        {
+            CHECK_THROWS_AS(heap.add(*sampler), orbi::descriptor_heap::error);
+        }
+
+        SUBCASE("removed index is reused")
+        {
+            heap.remove(first);
+            CHECK(heap.add(*sampler).index == first.index);
+        }
+
+        SUBCASE("slot is freed after move")
+        {
+            orbi::descriptor_heap moved{ std::move(heap) };
+            moved.remove(second);
+            CHECK(moved.add(*sampler).index == second.index);
+        }
+    }
+}
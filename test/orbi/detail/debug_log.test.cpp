@@ -0,0 +1,127 @@
+#include <doctest/doctest.h>
+
+#include <orbi/detail/debug_log.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct received
+{
+    std::int32_t id{ 0 };
+    std::string text;
+    std::uint64_t repeats{ 0 };
+};
+
+vk::DebugUtilsMessengerCallbackDataEXT
+message(std::int32_t const id, char const* const text)
+{
+    return { .pMessageIdName = "test-message", .messageIdNumber = id, .pMessage = text };
+}
+
+} // namespace
+
+TEST_SUITE("orbi::detail")
+{
+    TEST_CASE("debug_log delivers messages to all sinks")
+    {
+        std::mutex mutex;
+        std::vector<received> first;
+        std::vector<received> second;
+
+        auto const collect = [&](std::vector<received>& to)
+        {
+            return [&](orbi::debug_message const& m)
+            {
+                std::scoped_lock const lock{ mutex };
+                to.push_back({ .id = m.id, .text = std::string{ m.text }, .repeats = m.repeats });
+            };
+        };
+
+        {
+            orbi::detail::debug_log log{ { collect(first), collect(second) } };
+
+            CHECK(log.push(vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning,
+                           vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation, message(42, "hello")));
+        }
+
+        REQUIRE(first.size() == 1);
+        REQUIRE(second.size() == 1);
+        CHECK(first[0].id == 42);
+        CHECK(first[0].repeats == 0);
+        CHECK(first[0].text.find("hello") != std::string::npos);
+        CHECK(first[0].text.find("test-message") != std::string::npos);
+        CHECK(first[0].text == second[0].text);
+    }
+
+    TEST_CASE("debug_log reports repeated ids by summary")
+    {
+        std::mutex mutex;
+        std::vector<received> messages;
+
+        {
+            orbi::detail::debug_log log{ { [&](orbi::debug_message const& m)
+                                           {
+                                               std::scoped_lock const lock{ mutex };
+                                               messages.push_back(
+                                                   { .id = m.id, .text = std::string{ m.text }, .repeats = m.repeats });
+                                           } } };
+
+            auto const severity{ vk::DebugUtilsMessageSeverityFlagBitsEXT::eError };
+            auto const type{ vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation };
+
+            CHECK(log.push(severity, type, message(7, "first")));
+            for (int i{ 0 }; i < 5; ++i)
+            {
+                CHECK_FALSE(log.push(severity, type, message(7, "again")));
+            }
+
+            // id `0` means there is no id, so such messages aren't deduplicated
+            CHECK(log.push(severity, type, message(0, "no id")));
+            CHECK(log.push(severity, type, message(0, "no id")));
+        }
+
+        std::uint64_t first{ 0 };
+        std::uint64_t repeats{ 0 };
+        std::uint64_t without_id{ 0 };
+        for (auto const& m : messages)
+        {
+            if (m.id == 0)
+            {
+                ++without_id;
+            } else if (m.repeats == 0)
+            {
+                ++first;
+                CHECK(m.text.find("first") != std::string::npos);
+            } else
+            {
+                repeats += m.repeats;
+            }
+        }
+
+        CHECK(first == 1);
+        CHECK(repeats == 5);
+        CHECK(without_id == 2);
+    }
+
+    TEST_CASE("debug_log ignores exceptions of sinks")
+    {
+        int delivered{ 0 };
+
+        {
+            orbi::detail::debug_log log{ { [](orbi::debug_message const&) { throw 1; },
+                                           [&](orbi::debug_message const&) { ++delivered; } } };
+
+            log.push(vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning,
+                     vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral, message(1, "text"));
+        }
+
+        CHECK(delivered == 1);
+    }
+}
@@ -0,0 +1,82 @@
+#include <doctest/doctest.h>
+
+#include <orbi/detail/mpsc_queue.hpp>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+TEST_SUITE("orbi::detail")
+{
+    TEST_CASE("mpsc_queue::try_push fails if queue is full")
+    {
+        orbi::detail::mpsc_queue<int, 4> queue;
+
+        for (int i{ 0 }; i < 4; ++i)
+        {
+            CHECK(queue.try_push([i](int& v) noexcept { v = i; }));
+        }
+
+        CHECK_FALSE(queue.try_push([](int& v) noexcept { v = 4; }));
+
+        int popped{ -1 };
+        CHECK(queue.try_pop([&](int const& v) { popped = v; }));
+        CHECK(popped == 0);
+
+        CHECK(queue.try_push([](int& v) noexcept { v = 4; }));
+    }
+
+    TEST_CASE("mpsc_queue keeps order of each producer")
+    {
+        struct item
+        {
+            std::uint32_t producer{ 0 };
+            std::uint32_t sequence{ 0 };
+        };
+
+        constexpr std::uint32_t producer_count{ 4 };
+        constexpr std::uint32_t items_per_producer{ 10000 };
+
+        orbi::detail::mpsc_queue<item, 64> queue;
+
+        std::vector<std::jthread> producers;
+        for (std::uint32_t p{ 0 }; p < producer_count; ++p)
+        {
+            producers.emplace_back(
+                [&queue, p]
+                {
+                    for (std::uint32_t i{ 0 }; i < items_per_producer; ++i)
+                    {
+                        while (!queue.try_push([&](item& v) noexcept { v = { .producer = p, .sequence = i }; }))
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+        }
+
+        std::vector<std::uint32_t> next(producer_count, 0);
+        bool ordered{ true };
+
+        for (std::uint32_t received{ 0 }; received < producer_count * items_per_producer;)
+        {
+            if (queue.try_pop(
+                    [&](item const& v)
+                    {
+                        ordered = ordered && v.sequence == next[v.producer];
+                        ++next[v.producer];
+                    }))
+            {
+                ++received;
+            }
+        }
+
+        CHECK(ordered);
+        for (auto const n : next)
+        {
+            CHECK(n == items_per_producer);
+        }
+
+        CHECK_FALSE(queue.try_pop([](item const&) {}));
+    }
+}
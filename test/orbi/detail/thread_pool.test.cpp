@@ -0,0 +1,45 @@
+#include <doctest/doctest.h>
+
+#include <orbi/detail/thread_pool.hpp>
+
+#include <atomic>
+
+TEST_SUITE("orbi::detail")
+{
+    TEST_CASE("thread_pool::wait_until_idle")
+    {
+        std::atomic<int> done{ 0 };
+
+        orbi::detail::thread_pool pool{ 4 };
+        CHECK(pool.thread_count() == 4);
+
+        for (int i{ 0 }; i < 1000; ++i)
+        {
+            pool.submit([&] { ++done; });
+        }
+
+        pool.wait_until_idle();
+        CHECK(done == 1000);
+    }
+
+    TEST_CASE("thread_pool::~thread_pool finishes submitted tasks")
+    {
+        std::atomic<int> done{ 0 };
+
+        {
+            orbi::detail::thread_pool pool{ 2 };
+            for (int i{ 0 }; i < 100; ++i)
+            {
+                pool.submit([&] { ++done; });
+            }
+        }
+
+        CHECK(done == 100);
+    }
+
+    TEST_CASE("thread_pool::thread_pool uses at least one thread")
+    {
+        orbi::detail::thread_pool const pool;
+        CHECK(pool.thread_count() >= 1);
+    }
+}
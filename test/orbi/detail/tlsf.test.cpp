@@ -0,0 +1,85 @@
+#include <doctest/doctest.h>
+
+#include <orbi/detail/tlsf.hpp>
+
+#include <random>
+#include <vector>
+
+TEST_SUITE("orbi::detail")
+{
+    TEST_CASE("tlsf::allocate")
+    {
+        orbi::detail::tlsf ranges{ 1000 };
+
+        auto const whole{ ranges.allocate(1000) };
+        REQUIRE(whole);
+        CHECK(whole->offset == 0);
+        CHECK(ranges.used() == 1000);
+        CHECK(!ranges.allocate(1));
+
+        ranges.free(*whole);
+        CHECK(ranges.empty());
+        CHECK(ranges.largest_free() == 1000);
+
+        auto const aligned{ ranges.allocate(10, 256) };
+        REQUIRE(aligned);
+        CHECK(aligned->offset % 256 == 0);
+    }
+
+    TEST_CASE("tlsf::allocate finds aligned range in smaller class")
+    {
+        orbi::detail::tlsf ranges{ 258 };
+
+        auto const first{ ranges.allocate(128) };
+        auto const second{ ranges.allocate(130) };
+        REQUIRE(first);
+        REQUIRE(second);
+        CHECK(second->offset == 128);
+        ranges.free(*second);
+
+        // the only free range is smaller than `size + alignment - 1`, but its start is already aligned
+        auto const aligned{ ranges.allocate(100, 64) };
+        REQUIRE(aligned);
+        CHECK(aligned->offset == 128);
+    }
+
+    TEST_CASE("tlsf::free merges neighbours")
+    {
+        orbi::detail::tlsf ranges{ 1 << 20 };
+
+        std::mt19937 rng{ 42 };
+        std::vector<orbi::detail::tlsf::allocation> live;
+
+        for (int i{ 0 }; i < 10'000; ++i)
+        {
+            if (live.empty() || rng() % 2 == 0)
+            {
+                auto const size{ 1 + rng() % 5000 };
+                auto const alignment{ std::uint64_t{ 1 } << (rng() % 9) };
+
+                if (auto const a{ ranges.allocate(size, alignment) })
+                {
+                    CHECK(a->offset % alignment == 0);
+                    CHECK(a->size >= size);
+                    CHECK(a->offset + a->size <= ranges.capacity());
+
+                    live.push_back(*a);
+                }
+            } else
+            {
+                auto const it{ live.begin() + static_cast<std::ptrdiff_t>(rng() % live.size()) };
+                ranges.free(*it);
+                live.erase(it);
+            }
+        }
+
+        for (auto const& a : live)
+        {
+            ranges.free(a);
+        }
+
+        CHECK(ranges.used() == 0);
+        CHECK(ranges.free_range_count() == 1);
+        CHECK(ranges.largest_free() == ranges.capacity());
+    }
+}
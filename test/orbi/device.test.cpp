@@ -0,0 +1,116 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/window.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <initializer_list>
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("device::device")
+    {
+        orbi::context ctx;
+        orbi::window window{ ctx };
+
+        try
+        {
+            orbi::device device{ ctx, window };
+        }
+        catch (orbi::device::error const&)
+        {
+        }
+        catch (...)
+        {
+            // `orbi::device::device` must throw only documented exception type
+            REQUIRE(false);
+        }
+    }
+
+    TEST_CASE("device::candidates")
+    {
+        orbi::context ctx;
+        orbi::window window{ ctx };
+
+        orbi::device_options const options{ .required_extensions = { "VK_ORBI_surely_unsupported_extension" } };
+
+        for (auto const& candidate : orbi::device::candidates(ctx, window, options))
+        {
+            // every rejected candidate must say why it was rejected
+            CHECK(!candidate.suitable());
+            CHECK(candidate.score == 0);
+            CHECK(!candidate.rejection_reasons.empty());
+        }
+
+        // explicit override, which doesn't match any device, must not silently fall back to other device
+        orbi::device_options const no_such_device{ .preferred_name = "orbi: there is no such device",
+                                                   .override_env = "" };
+        CHECK_THROWS_AS(orbi::device(ctx, window, no_such_device), orbi::device::error);
+    }
+
+    TEST_CASE("device::device headless")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        for (auto const& candidate : orbi::device::candidates(ctx))
+        {
+            CHECK(candidate.suitable() == (candidate.score > 0));
+        }
+
+        try
+        {
+            orbi::device const device{ ctx };
+            CHECK(device.headless());
+        }
+        catch (orbi::device::error const&)
+        {
+        }
+        catch (...)
+        {
+            // `orbi::device::device` must throw only documented exception type
+            REQUIRE(false);
+        }
+    }
+
+    TEST_CASE("device::device names objects with markers")
+    {
+        for (auto const level : { orbi::instrumentation::none, orbi::instrumentation::markers })
+        {
+            CAPTURE(static_cast<int>(level));
+
+            orbi::context const ctx{ {}, { .headless = true, .instrumentation_level = level } };
+
+            // queues are named right in constructor
+            auto device{ test::make_device(ctx) };
+            if (!device)
+            {
+                return;
+            }
+
+            auto const& device_impl{ orbi::device::impl::from_device(*device) };
+
+            // without `VK_EXT_debug_utils` its functions aren't loaded, so calling them would crash
+            CHECK(device_impl.debug_markers == (level == orbi::instrumentation::markers));
+
+            vk::raii::CommandPool const pool{ device_impl.vk_device,
+                                              { .queueFamilyIndex = device_impl.graphics_queue.family_index } };
+            vk::raii::CommandBuffers const command_buffers{
+                device_impl.vk_device,
+                { .commandPool = pool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1 }
+            };
+            auto const& command_buffer{ command_buffers.front() };
+
+            CHECK_NOTHROW(device_impl.set_name(*pool, "orbi test pool {}", 0));
+
+            command_buffer.begin({});
+            CHECK_NOTHROW(device_impl.begin_label(command_buffer, "orbi test label"));
+            CHECK_NOTHROW(device_impl.end_label(command_buffer));
+            command_buffer.end();
+        }
+    }
+}
@@ -0,0 +1,147 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/external.hpp>
+#include <orbi/offscreen_target.hpp>
+#include <orbi/renderer.hpp>
+#include <orbi/rendering.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#ifndef _WIN32
+
+namespace
+{
+
+constexpr std::array<std::uint8_t, 4> color{ 32, 64, 128, 255 };
+
+// everything is rendered and read back in this layout
+constexpr auto shared_layout{ vk::ImageLayout::eTransferSrcOptimal };
+
+/*
+    imports image and semaphore into `device`, reads image back once semaphore is signaled
+
+    `device` is other `VkDevice` than the exporting one, so it sees only what is shared through descriptors,
+    the same as other process would
+*/
+std::array<std::uint8_t, 4>
+consume(orbi::device& device, orbi::external_image const& image,
+        vk::ExternalSemaphoreHandleTypeFlagBits const semaphore_handle_type, int const semaphore_fd)
+{
+    auto const& device_impl{ orbi::device::impl::from_device(device) };
+    auto const& vk_device{ device_impl.vk_device };
+
+    auto const target{ orbi::offscreen_target::import_image(device, image) };
+
+    orbi::external_semaphore semaphore{ device };
+    REQUIRE(semaphore.handle_type() == semaphore_handle_type);
+    semaphore.import_fd(semaphore_fd);
+
+    vk::raii::Buffer const buffer{ vk_device, { .size = 4, .usage = vk::BufferUsageFlagBits::eTransferDst } };
+    auto const allocation{ device.allocator().allocate(
+        { .requirements = buffer.getMemoryRequirements(), .usage = orbi::memory_usage::readback }) };
+    buffer.bindMemory(allocation.memory, allocation.offset);
+
+    vk::raii::CommandPool const command_pool{ vk_device,
+                                              { .queueFamilyIndex = device_impl.graphics_queue.family_index } };
+    auto const command_buffer{ std::move(
+        vk_device.allocateCommandBuffers({ .commandPool = command_pool, .commandBufferCount = 1 }).front()) };
+
+    command_buffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    orbi::acquire_from_external(device, command_buffer, target.image(), shared_layout,
+                                orbi::image_states::transfer_source);
+    command_buffer.copyImageToBuffer(
+        target.image(), shared_layout, buffer,
+        vk::BufferImageCopy{ .imageSubresource = { .aspectMask = vk::ImageAspectFlagBits::eColor, .layerCount = 1 },
+                             .imageExtent = { 1, 1, 1 } });
+
+    vk::MemoryBarrier2 const host_barrier{ .srcStageMask = vk::PipelineStageFlagBits2::eTransfer,
+                                           .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+                                           .dstStageMask = vk::PipelineStageFlagBits2::eHost,
+                                           .dstAccessMask = vk::AccessFlagBits2::eHostRead };
+    command_buffer.pipelineBarrier2({ .memoryBarrierCount = 1, .pMemoryBarriers = &host_barrier });
+    command_buffer.end();
+
+    vk::SemaphoreSubmitInfo const wait_info{ .semaphore = semaphore.semaphore(),
+                                             .stageMask = vk::PipelineStageFlagBits2::eAllCommands };
+    vk::CommandBufferSubmitInfo const command_buffer_info{ .commandBuffer = command_buffer };
+    vk::raii::Fence const done{ vk_device, vk::FenceCreateInfo{} };
+
+    device_impl.graphics_queue.vk_queue.submit2(vk::SubmitInfo2{ .waitSemaphoreInfoCount = 1,
+                                                                 .pWaitSemaphoreInfos = &wait_info,
+                                                                 .commandBufferInfoCount = 1,
+                                                                 .pCommandBufferInfos = &command_buffer_info },
+                                                done);
+    static_cast<void>(vk_device.waitForFences(*done, vk::True, std::numeric_limits<std::uint64_t>::max()));
+
+    std::array<std::uint8_t, 4> pixel{};
+    std::memcpy(pixel.data(), allocation.mapped, pixel.size());
+    device.allocator().free(allocation);
+
+    return pixel;
+}
+
+} // namespace
+
+TEST_SUITE("orbi")
+{
+    // both ends live in this process, but on separate devices, which share memory and semaphore only by fds
+    TEST_CASE("external memory is shared with other device")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        orbi::device_options const options{ .external_memory = true };
+        auto producer{ test::make_device(ctx, options) };
+        auto consumer{ test::make_device(ctx, options) };
+        if (!producer || !consumer)
+        {
+            return;
+        }
+
+        orbi::offscreen_target const target{ *producer, { 1, 1 }, orbi::offscreen_target::default_format, true };
+        orbi::external_semaphore const semaphore{ *producer };
+        orbi::renderer renderer{ *producer };
+
+        renderer.begin_frame();
+
+        auto& renderer_impl{ orbi::renderer::impl::from_renderer(renderer) };
+        auto const& command_buffer{ renderer_impl.current().command_buffer };
+        command_buffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+        orbi::transition(command_buffer, target.image(), orbi::image_states::discarded,
+                         orbi::image_states::color_attachment);
+
+        std::array const color_attachments{ orbi::color_attachment_info{
+            .view = target.view(),
+            .clear_color = vk::ClearColorValue{ std::array{ color[0] / 255.f, color[1] / 255.f, color[2] / 255.f,
+                                                            color[3] / 255.f } } } };
+        orbi::begin_rendering(command_buffer, { { 0, 0 }, target.extent() }, color_attachments);
+        command_buffer.endRendering();
+
+        orbi::release_to_external(*producer, command_buffer, target.image(), orbi::image_states::color_attachment,
+                                  shared_layout);
+        command_buffer.end();
+
+        std::array const signal{ semaphore.semaphore() };
+        renderer_impl.submit(orbi::device::impl::from_device(*producer).graphics_queue.vk_queue, signal);
+
+        // imports take ownership of descriptors
+        auto const image{ target.export_image() };
+        CHECK(consume(*consumer, image, semaphore.handle_type(), semaphore.export_fd()) == color);
+
+        renderer.end_frame();
+        producer->wait_until_idle();
+        consumer->wait_until_idle();
+    }
+}
+
+#endif
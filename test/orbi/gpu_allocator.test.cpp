@@ -0,0 +1,118 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/gpu_allocator.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("gpu_allocator")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        auto device{ test::make_device(ctx) };
+        if (!device)
+        {
+            return;
+        }
+
+        auto const& vk_device{ orbi::device::impl::from_device(*device).vk_device };
+
+        constexpr vk::DeviceSize block_size{ 1024 * 1024 };
+        constexpr vk::DeviceSize size{ 64 * 1024 };
+        constexpr std::size_t count{ 8 };
+
+        orbi::gpu_allocator allocator{ *device, block_size };
+
+        // only memory types are taken from real buffer
+        vk::raii::Buffer const buffer{ vk_device,
+                                       { .size = size, .usage = vk::BufferUsageFlagBits::eStorageBuffer } };
+        auto const allocate = [&](vk::DeviceSize const allocation_size)
+        {
+            auto requirements{ buffer.getMemoryRequirements() };
+            requirements.size = allocation_size;
+
+            return allocator.allocate({ .requirements = requirements, .usage = orbi::memory_usage::upload });
+        };
+        auto const alignment{ buffer.getMemoryRequirements().alignment };
+
+        std::vector<orbi::gpu_allocation> allocations;
+        for (std::size_t i{ 0 }; i < count; ++i)
+        {
+            allocations.push_back(allocate(size));
+
+            auto const& a{ allocations.back() };
+            REQUIRE(a);
+            CHECK(a.mapped != nullptr);
+            CHECK(a.offset % alignment == 0);
+        }
+
+        auto stats{ allocator.stats() };
+        CHECK(stats.block_count == 1);
+        CHECK(stats.dedicated_count == 0);
+        CHECK(stats.allocation_count == count);
+        CHECK(stats.used_bytes >= count * size);
+        CHECK(stats.fragmentation == 0);
+
+        // allocations of one block don't overlap
+        std::ranges::sort(allocations, {}, &orbi::gpu_allocation::offset);
+        for (std::size_t i{ 1 }; i < allocations.size(); ++i)
+        {
+            CHECK(allocations[i].memory == allocations[0].memory);
+            CHECK(allocations[i - 1].offset + allocations[i - 1].size <= allocations[i].offset);
+        }
+
+        SUBCASE("freed holes fragment block")
+        {
+            for (std::size_t i{ 0 }; i < count; i += 2)
+            {
+                allocator.free(allocations[i]);
+            }
+
+            stats = allocator.stats();
+            CHECK(stats.allocation_count == count / 2);
+            CHECK(stats.fragmentation > 0);
+
+            // block isn't full, so no other one is allocated
+            auto const next{ allocate(size) };
+            CHECK(next.memory == allocations[0].memory);
+            CHECK(allocator.stats().block_count == 1);
+            allocator.free(next);
+
+            for (std::size_t i{ 1 }; i < count; i += 2)
+            {
+                allocator.free(allocations[i]);
+            }
+
+            stats = allocator.stats();
+            CHECK(stats.allocation_count == 0);
+            CHECK(stats.used_bytes == 0);
+            CHECK(stats.fragmentation == 0);
+        }
+
+        SUBCASE("large allocation is dedicated")
+        {
+            auto const large{ allocate(block_size) };
+            REQUIRE(large);
+            CHECK(large.memory != allocations[0].memory);
+            CHECK(allocator.stats().dedicated_count == 1);
+
+            allocator.free(large);
+            CHECK(allocator.stats().dedicated_count == 0);
+
+            for (auto const& a : allocations)
+            {
+                allocator.free(a);
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/gpu_profiler.hpp>
+#include <orbi/renderer.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <string_view>
+
+namespace
+{
+
+// one frame, which begins profiler frame and records `scope` unless it's empty
+void
+render(orbi::device const& device, orbi::renderer& renderer, orbi::gpu_profiler& profiler,
+       std::string_view const scope)
+{
+    renderer.begin_frame();
+
+    auto& renderer_impl{ orbi::renderer::impl::from_renderer(renderer) };
+    auto const& command_buffer{ renderer_impl.current().command_buffer };
+    command_buffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+    profiler.begin_frame(renderer, command_buffer);
+
+    if (!scope.empty())
+    {
+        orbi::gpu_scope const s{ profiler, command_buffer, scope };
+
+        vk::MemoryBarrier2 const barrier{ .srcStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+                                          .dstStageMask = vk::PipelineStageFlagBits2::eAllCommands };
+        command_buffer.pipelineBarrier2({ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+    }
+
+    command_buffer.end();
+
+    renderer_impl.submit(orbi::device::impl::from_device(device).graphics_queue.vk_queue);
+    renderer.end_frame();
+}
+
+} // namespace
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("gpu_profiler")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        auto device{ test::make_device(ctx) };
+        if (!device)
+        {
+            return;
+        }
+
+        auto const& device_impl{ orbi::device::impl::from_device(*device) };
+        auto const families{ device_impl.vk_physical_device.getQueueFamilyProperties() };
+        if (families[device_impl.graphics_queue.family_index].timestampValidBits == 0)
+        {
+            MESSAGE("graphics queue doesn't support timestamps, test is skipped");
+            return;
+        }
+
+        // one frame in flight, so the next frame reads results of the previous one
+        orbi::renderer renderer{ *device, 1 };
+        orbi::gpu_profiler profiler{ *device, 1 };
+
+        render(*device, renderer, profiler, "scope");
+        CHECK(profiler.stats().empty());
+
+        render(*device, renderer, profiler, {});
+
+        auto const stats{ profiler.stats() };
+        REQUIRE(stats.size() == 1);
+        CHECK(stats[0].name == "scope");
+        CHECK(stats[0].sample_count == 1);
+        CHECK(stats[0].min_ms >= 0);
+        CHECK(stats[0].min_ms == stats[0].max_ms);
+        CHECK(profiler.dropped_scopes() == 0);
+
+        device->wait_until_idle();
+    }
+}
@@ -0,0 +1,103 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/gpu_allocator.hpp>
+#include <orbi/indirect_draws.hpp>
+#include <orbi/renderer.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <cstring>
+
+namespace
+{
+
+// clip space of vulkan: `-1 <= x, y <= 1` and `0 <= z <= 1`
+constexpr std::array<float, 16> identity{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+} // namespace
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("make_frustum")
+    {
+        auto const f{ orbi::make_frustum(identity) };
+
+        CHECK(f.planes[0] == std::array{ 1.f, 0.f, 0.f, 1.f });
+        CHECK(f.planes[1] == std::array{ -1.f, 0.f, 0.f, 1.f });
+        CHECK(f.planes[2] == std::array{ 0.f, 1.f, 0.f, 1.f });
+        CHECK(f.planes[3] == std::array{ 0.f, -1.f, 0.f, 1.f });
+        CHECK(f.planes[4] == std::array{ 0.f, 0.f, 1.f, 0.f });
+        CHECK(f.planes[5] == std::array{ 0.f, 0.f, -1.f, 1.f });
+    }
+
+    TEST_CASE("indirect_draws")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        auto device{ test::make_device(ctx, orbi::device_options{ .bindless = true, .indirect_draw = true }) };
+        if (!device)
+        {
+            return;
+        }
+
+        auto const& device_impl{ orbi::device::impl::from_device(*device) };
+        auto const& vk_device{ device_impl.vk_device };
+
+        orbi::indirect_draws draws{ *device, 1, 4 };
+        CHECK(draws.max_objects() == 4);
+        CHECK(draws.objects());
+
+        std::array const objects{
+            orbi::draw_object{ .sphere = { 0, 0, 0.5f, 0.1f }, .index_count = 3, .instance = 0 },
+            orbi::draw_object{ .sphere = { 5, 0, 0.5f, 0.1f }, .index_count = 3, .instance = 1 },
+            orbi::draw_object{ .sphere = { 0, -5, 0.5f, 0.1f }, .index_count = 3, .instance = 2 },
+            // intersects right plane
+            orbi::draw_object{ .sphere = { 1.05f, 0, 0.5f, 0.1f }, .index_count = 6, .instance = 3 },
+        };
+
+        vk::raii::Buffer const buffer{ vk_device, { .size = sizeof(std::uint32_t),
+                                                    .usage = vk::BufferUsageFlagBits::eTransferDst } };
+
+        auto const allocation{ device->allocator().allocate(
+            { .requirements = buffer.getMemoryRequirements(), .usage = orbi::memory_usage::readback }) };
+        buffer.bindMemory(allocation.memory, allocation.offset);
+
+        orbi::renderer renderer{ *device, 1 };
+        renderer.begin_frame();
+
+        auto& renderer_impl{ orbi::renderer::impl::from_renderer(renderer) };
+        auto const& command_buffer{ renderer_impl.current().command_buffer };
+        command_buffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+        draws.update(command_buffer, 0, objects);
+        draws.cull(renderer, command_buffer, orbi::make_frustum(identity),
+                   static_cast<std::uint32_t>(objects.size()));
+
+        vk::MemoryBarrier2 const barrier{ .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+                                          .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                                          .dstStageMask = vk::PipelineStageFlagBits2::eTransfer,
+                                          .dstAccessMask = vk::AccessFlagBits2::eTransferRead };
+        command_buffer.pipelineBarrier2({ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+
+        auto const& draws_impl{ orbi::indirect_draws::impl::from_indirect_draws(draws) };
+        command_buffer.copyBuffer(draws_impl.draws[0].buffer, buffer,
+                                  vk::BufferCopy{ .srcOffset = 0, .dstOffset = 0, .size = sizeof(std::uint32_t) });
+        command_buffer.end();
+
+        renderer_impl.submit(device_impl.graphics_queue.vk_queue);
+        device->wait_until_idle();
+
+        // memory of `memory_usage::readback` is coherent
+        std::uint32_t count{ 0 };
+        std::memcpy(&count, allocation.mapped, sizeof(count));
+        CHECK(count == 2);
+
+        device->allocator().free(allocation);
+    }
+}
@@ -0,0 +1,80 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/gpu_allocator.hpp>
+#include <orbi/offscreen_target.hpp>
+#include <orbi/renderer.hpp>
+#include <orbi/rendering.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <cstring>
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("offscreen_target")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        auto device{ test::make_device(ctx) };
+        if (!device)
+        {
+            return;
+        }
+
+        auto const& device_impl{ orbi::device::impl::from_device(*device) };
+        auto const& vk_device{ device_impl.vk_device };
+
+        vk::Extent2D const extent{ 4, 4 };
+        orbi::offscreen_target const target{ *device, extent };
+        CHECK(target.image());
+        CHECK(target.view());
+        CHECK(target.format() == orbi::offscreen_target::default_format);
+
+        vk::DeviceSize const size{ std::uint64_t{ extent.width } * extent.height * 4 };
+        vk::raii::Buffer const buffer{ vk_device, { .size = size, .usage = vk::BufferUsageFlagBits::eTransferDst } };
+
+        auto const allocation{ device->allocator().allocate(
+            { .requirements = buffer.getMemoryRequirements(), .usage = orbi::memory_usage::readback }) };
+        buffer.bindMemory(allocation.memory, allocation.offset);
+
+        orbi::renderer renderer{ *device, 1 };
+        renderer.begin_frame();
+
+        auto const& command_buffer{ orbi::renderer::impl::from_renderer(renderer).current().command_buffer };
+        command_buffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+        orbi::transition(command_buffer, target.image(), orbi::image_states::discarded,
+                         orbi::image_states::color_attachment);
+
+        std::array const color_attachments{ orbi::color_attachment_info{
+            .view = target.view(), .clear_color = vk::ClearColorValue{ std::array{ 1.f, 0.f, 0.f, 1.f } } } };
+        orbi::begin_rendering(command_buffer, { { 0, 0 }, extent }, color_attachments);
+        command_buffer.endRendering();
+
+        orbi::transition(command_buffer, target.image(), orbi::image_states::color_attachment,
+                         orbi::image_states::transfer_source);
+
+        command_buffer.copyImageToBuffer(target.image(), vk::ImageLayout::eTransferSrcOptimal, buffer,
+                                         vk::BufferImageCopy{ .imageSubresource = { .aspectMask =
+                                                                                        vk::ImageAspectFlagBits::eColor,
+                                                                                    .layerCount = 1 },
+                                                              .imageExtent = { extent.width, extent.height, 1 } });
+        command_buffer.end();
+
+        orbi::renderer::impl::from_renderer(renderer).submit(device_impl.graphics_queue.vk_queue);
+        device->wait_until_idle();
+
+        // memory of `memory_usage::readback` is coherent
+        std::array<std::uint8_t, 4> pixel{};
+        std::memcpy(pixel.data(), allocation.mapped, pixel.size());
+        CHECK(pixel == std::array<std::uint8_t, 4>{ 255, 0, 0, 255 });
+
+        device->allocator().free(allocation);
+    }
+}
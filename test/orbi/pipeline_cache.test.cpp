@@ -0,0 +1,65 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/device.hpp>
+#include <orbi/pipeline_cache.hpp>
+#include <orbi/window.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("pipeline_cache")
+    {
+        orbi::context ctx;
+        orbi::window window{ ctx };
+
+        auto device{ test::make_device(ctx, window) };
+        if (!device)
+        {
+            return;
+        }
+
+        auto const directory{ std::filesystem::temp_directory_path() / "orbi_pipeline_cache_test" };
+        std::filesystem::remove_all(directory);
+
+        {
+            orbi::pipeline_cache const cache{ *device, directory };
+            CHECK(!cache.warm());
+            cache.save();
+        }
+
+        // only cache file is left, temporary one is renamed
+        std::filesystem::path file;
+        for (auto const& entry : std::filesystem::directory_iterator{ directory })
+        {
+            CHECK(file.empty());
+            file = entry.path();
+        }
+        REQUIRE(!file.empty());
+        CHECK(file.extension() == ".bin");
+
+        {
+            orbi::pipeline_cache const cache{ *device, directory };
+            CHECK(cache.warm());
+        }
+
+        // corrupted cache must not be handed to driver
+        {
+            std::fstream f{ file, std::ios::binary | std::ios::in | std::ios::out };
+            f.seekg(-1, std::ios::end);
+            auto const last{ static_cast<char>(f.get()) };
+            f.seekp(-1, std::ios::end);
+            f.put(static_cast<char>(last ^ 0x5a));
+        }
+        {
+            orbi::pipeline_cache const cache{ *device, directory };
+            CHECK(!cache.warm());
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+}
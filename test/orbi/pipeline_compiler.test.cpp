@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/pipeline_compiler.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+// generated by `orbi_target_shaders`, define `test_shaders::shaders` and `test_fragment_shaders::shaders`
+#include <test/fragment_shaders.hpp>
+#include <test/shaders.hpp>
+
+#include <future>
+
+namespace
+{
+
+orbi::graphics_pipeline_description
+triangle(vk::PipelineLayout const layout)
+{
+    return { .vertex = { .code = test_shaders::shaders.at("triangle.vert") },
+             .fragment = { .code = test_fragment_shaders::shaders.at("triangle.frag") },
+             .color_formats = { vk::Format::eR8G8B8A8Unorm },
+             .layout = layout };
+}
+
+} // namespace
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("pipeline_compiler")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        auto device{ test::make_device(ctx) };
+        if (!device)
+        {
+            return;
+        }
+
+        vk::raii::PipelineLayout const layout{ orbi::device::impl::from_device(*device).vk_device,
+                                               vk::PipelineLayoutCreateInfo{} };
+
+        // one worker thread, so compilation can be held back by a task queued before it
+        orbi::pipeline_compiler compiler{ *device, 1 };
+
+        auto const placeholder{ compiler.compile(triangle(*layout)) };
+        auto const placeholder_pipeline{ compiler.wait(placeholder) };
+        REQUIRE(placeholder_pipeline);
+        CHECK(compiler.status(placeholder) == orbi::pipeline_status::ready);
+
+        std::promise<void> release;
+        orbi::pipeline_compiler::impl::from_compiler(compiler).pool->submit([gate = release.get_future().share()]
+                                                                            { gate.wait(); });
+
+        auto const h{ compiler.compile(triangle(*layout)) };
+
+        // worker is still held, so compilation of `h` hasn't even started
+        CHECK(compiler.status(h) == orbi::pipeline_status::pending);
+        CHECK_FALSE(compiler.get(h));
+        CHECK(compiler.get_or(h, placeholder) == placeholder_pipeline);
+
+        release.set_value();
+
+        auto const pipeline{ compiler.wait(h) };
+        REQUIRE(pipeline);
+        CHECK(pipeline != placeholder_pipeline);
+        CHECK(compiler.status(h) == orbi::pipeline_status::ready);
+        CHECK(compiler.get(h) == pipeline);
+        CHECK(compiler.get_or(h, placeholder) == pipeline);
+    }
+}
@@ -0,0 +1,117 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/offscreen_target.hpp>
+#include <orbi/readback_stream.hpp>
+#include <orbi/renderer.hpp>
+#include <orbi/rendering.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+// clears `target` with red channel set to `red`
+void
+render(orbi::device const& device, orbi::renderer& renderer, orbi::offscreen_target const& target,
+       std::uint8_t const red)
+{
+    renderer.begin_frame();
+
+    auto& renderer_impl{ orbi::renderer::impl::from_renderer(renderer) };
+    auto const& command_buffer{ renderer_impl.current().command_buffer };
+    command_buffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+    orbi::transition(command_buffer, target.image(), orbi::image_states::discarded,
+                     orbi::image_states::color_attachment);
+
+    std::array const color_attachments{ orbi::color_attachment_info{
+        .view = target.view(),
+        .clear_color = vk::ClearColorValue{ std::array{ static_cast<float>(red) / 255.f, 0.f, 0.f, 1.f } } } };
+    orbi::begin_rendering(command_buffer, { { 0, 0 }, target.extent() }, color_attachments);
+    command_buffer.endRendering();
+
+    command_buffer.end();
+
+    renderer_impl.submit(orbi::device::impl::from_device(device).graphics_queue.vk_queue);
+    renderer.end_frame();
+}
+
+} // namespace
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("readback_stream")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        auto device{ test::make_device(ctx) };
+        if (!device)
+        {
+            return;
+        }
+
+        orbi::offscreen_target const target{ *device, { 4, 4 } };
+        orbi::renderer renderer{ *device };
+
+        SUBCASE("frames are consumed in order of push")
+        {
+            // written only by worker thread, read after `flush`
+            std::vector<std::pair<std::uint64_t, std::uint8_t>> consumed;
+
+            orbi::readback_stream stream{ *device, target.extent(), target.format(),
+                                          [&](orbi::readback_frame const& frame)
+                                          {
+                                              CHECK(frame.pixels.size() == 4 * 4 * 4);
+                                              consumed.emplace_back(frame.index,
+                                                                    static_cast<std::uint8_t>(frame.pixels[0]));
+                                          },
+                                          2 };
+
+            constexpr std::uint8_t frame_count{ 8 };
+            for (std::uint8_t i{ 0 }; i < frame_count; ++i)
+            {
+                render(*device, renderer, target, static_cast<std::uint8_t>(i * 30));
+                stream.push(target);
+            }
+
+            stream.flush();
+
+            REQUIRE(consumed.size() == frame_count);
+            for (std::uint8_t i{ 0 }; i < frame_count; ++i)
+            {
+                CHECK(consumed[i].first == i);
+                CHECK(consumed[i].second == i * 30);
+            }
+
+            auto const stats{ stream.stats() };
+            CHECK(stats.frames_consumed == frame_count);
+            CHECK(stats.bytes_consumed == frame_count * 4 * 4 * 4);
+        }
+
+        SUBCASE("failure of consumer stops stream")
+        {
+            orbi::readback_stream stream{ *device, target.extent(), target.format(),
+                                          [](orbi::readback_frame const&)
+                                          { throw std::runtime_error{ "consumer failed" }; } };
+
+            render(*device, renderer, target, 0);
+            stream.push(target);
+
+            CHECK_THROWS_AS(stream.flush(), orbi::readback_stream::error);
+            CHECK_THROWS_AS(stream.push(target, orbi::image_states::transfer_source), orbi::readback_stream::error);
+        }
+
+        device->wait_until_idle();
+    }
+}
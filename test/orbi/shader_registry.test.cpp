@@ -0,0 +1,36 @@
+#include <doctest/doctest.h>
+
+#include <orbi/shader_registry.hpp>
+
+// generated by `orbi_target_shaders`, defines `test_shaders::shaders`
+#include <test/shaders.hpp>
+
+#include <cstdint>
+
+namespace
+{
+
+constexpr std::uint32_t spirv_magic{ 0x07230203 };
+
+// lookup works at compile time
+static_assert(test_shaders::shaders.at("triangle.vert").front() == spirv_magic);
+static_assert(test_shaders::shaders.find("triangle.frag").empty());
+
+} // namespace
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("shader_registry")
+    {
+        CHECK(test_shaders::shaders.size() == 1);
+
+        for (auto const& s : test_shaders::shaders)
+        {
+            CHECK(s.name == "triangle.vert");
+            REQUIRE(!s.code.empty());
+            CHECK(s.code.front() == spirv_magic);
+        }
+
+        CHECK_THROWS_AS(test_shaders::shaders.at("missing"), orbi::shader_registry_error);
+    }
+}
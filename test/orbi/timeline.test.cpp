@@ -0,0 +1,73 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/timeline.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <chrono>
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("timeline")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        auto device{ test::make_device(ctx) };
+        if (!device)
+        {
+            return;
+        }
+
+        orbi::timeline t{ *device, 5 };
+        CHECK(t.semaphore());
+        CHECK(t.last() == 5);
+        CHECK(t.cached() == 5);
+        CHECK(t.reached(5));
+
+        SUBCASE("cpu signal and wait")
+        {
+            auto const value{ t.advance() };
+            CHECK(value == 6);
+            CHECK(t.last() == 6);
+
+            CHECK_FALSE(t.reached(value));
+            CHECK_FALSE(t.wait(value, std::chrono::milliseconds{ 1 }));
+
+            t.signal(value);
+            CHECK(t.cached() == value);
+            CHECK(t.wait(value));
+            CHECK(t.completed() == value);
+        }
+
+        SUBCASE("submission waits for other timeline")
+        {
+            orbi::timeline const other{ *device };
+
+            auto const& queue{ orbi::device::impl::from_device(*device).graphics_queue.vk_queue };
+
+            auto const released{ other.last() + 1 };
+            auto const done{ t.advance() };
+
+            auto const wait_info{ other.submit_info(released) };
+            auto const signal_info{ t.submit_info(done) };
+            queue.submit2(vk::SubmitInfo2{ .waitSemaphoreInfoCount = 1,
+                                           .pWaitSemaphoreInfos = &wait_info,
+                                           .signalSemaphoreInfoCount = 1,
+                                           .pSignalSemaphoreInfos = &signal_info });
+
+            CHECK_FALSE(t.wait(done, std::chrono::milliseconds{ 10 }));
+
+            other.signal(released);
+            CHECK(t.wait(done));
+            CHECK(t.reached(done));
+        }
+
+        device->wait_until_idle();
+    }
+}
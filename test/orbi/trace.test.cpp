@@ -0,0 +1,49 @@
+#include <doctest/doctest.h>
+
+#include <orbi/trace.hpp>
+
+#include <sstream>
+#include <thread>
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("trace::write_chrome_json")
+    {
+        orbi::trace::clear();
+
+        {
+            ORBI_TRACE_SCOPE("trace \"test\"");
+
+            std::thread worker{ [] { ORBI_TRACE_SCOPE("trace worker"); } };
+            worker.join();
+        }
+
+        // ring of exited thread is reused by the next one, but its events are still exported
+        std::thread{ [] { ORBI_TRACE_SCOPE("trace first"); } }.join();
+        std::thread{ [] { ORBI_TRACE_SCOPE("trace second"); } }.join();
+
+        std::ostringstream out;
+        orbi::trace::write_chrome_json(out);
+        auto const json{ out.str() };
+
+        CHECK(json.starts_with(R"({"displayTimeUnit":"ms","traceEvents":[)"));
+        CHECK(json.ends_with("]}\n"));
+
+#ifdef ORBI_TRACE
+        // names are escaped
+        CHECK(json.find(R"("name":"trace \"test\"")") != std::string::npos);
+        CHECK(json.find(R"("name":"trace worker")") != std::string::npos);
+        CHECK(json.find(R"("name":"trace first")") != std::string::npos);
+        CHECK(json.find(R"("name":"trace second")") != std::string::npos);
+#else
+        // disabled tracing records nothing
+        CHECK(json.find("trace worker") == std::string::npos);
+#endif
+
+        orbi::trace::clear();
+
+        std::ostringstream cleared;
+        orbi::trace::write_chrome_json(cleared);
+        CHECK(cleared.str().find("trace worker") == std::string::npos);
+    }
+}
@@ -0,0 +1,201 @@
+#include <doctest/doctest.h>
+
+#include <test/device.hpp>
+
+#include <orbi/context.hpp>
+#include <orbi/detail/impl.hpp>
+#include <orbi/device.hpp>
+#include <orbi/gpu_allocator.hpp>
+#include <orbi/renderer.hpp>
+#include <orbi/uploader.hpp>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace
+{
+
+/*
+    acquires uploaded resources on graphics queue, records `commands` and waits until they are done,
+    so host sees everything written by transfers
+*/
+void
+submit(orbi::device& device, orbi::renderer& renderer, orbi::uploader& uploader,
+       std::function<void(vk::raii::CommandBuffer const&)> const& commands = {})
+{
+    renderer.begin_frame();
+
+    auto& renderer_impl{ orbi::renderer::impl::from_renderer(renderer) };
+    auto const& command_buffer{ renderer_impl.current().command_buffer };
+    command_buffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+    uploader.acquire(renderer, command_buffer);
+
+    if (commands)
+    {
+        commands(command_buffer);
+    }
+
+    vk::MemoryBarrier2 const barrier{ .srcStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+                                      .srcAccessMask = vk::AccessFlagBits2::eMemoryWrite,
+                                      .dstStageMask = vk::PipelineStageFlagBits2::eHost,
+                                      .dstAccessMask = vk::AccessFlagBits2::eHostRead };
+    command_buffer.pipelineBarrier2({ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+
+    command_buffer.end();
+
+    renderer_impl.submit(orbi::device::impl::from_device(device).graphics_queue.vk_queue);
+    renderer.end_frame();
+
+    device.wait_until_idle();
+}
+
+std::vector<std::byte>
+make_bytes(std::size_t const size, std::size_t const seed)
+{
+    std::vector<std::byte> bytes(size);
+    for (std::size_t i{ 0 }; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::byte>(i * 7 + seed);
+    }
+
+    return bytes;
+}
+
+} // namespace
+
+TEST_SUITE("orbi")
+{
+    TEST_CASE("uploader")
+    {
+        orbi::context const ctx{ {}, { .headless = true } };
+
+        auto device{ test::make_device(ctx) };
+        if (!device)
+        {
+            return;
+        }
+
+        auto const& vk_device{ orbi::device::impl::from_device(*device).vk_device };
+
+        orbi::renderer renderer{ *device };
+
+        SUBCASE("buffer")
+        {
+            constexpr std::size_t chunk_size{ 100 };
+            constexpr std::size_t chunk_count{ 8 };
+
+            vk::raii::Buffer const buffer{ vk_device, { .size = chunk_size * chunk_count,
+                                                        .usage = vk::BufferUsageFlagBits::eTransferDst } };
+
+            auto const allocation{ device->allocator().allocate(
+                { .requirements = buffer.getMemoryRequirements(), .usage = orbi::memory_usage::readback }) };
+            buffer.bindMemory(allocation.memory, allocation.offset);
+
+            // ring holds only a few chunks, so it wraps around and uploads wait for space
+            orbi::uploader uploader{ *device, 256 };
+
+            auto const expected{ make_bytes(chunk_size * chunk_count, 0) };
+
+            for (std::size_t i{ 0 }; i < chunk_count; ++i)
+            {
+                std::span const chunk{ expected.data() + i * chunk_size, chunk_size };
+                uploader.upload(*buffer, i * chunk_size, chunk);
+            }
+
+            uploader.flush();
+            submit(*device, renderer, uploader);
+
+            // memory of `memory_usage::readback` is coherent
+            std::vector<std::byte> actual(expected.size());
+            std::memcpy(actual.data(), allocation.mapped, actual.size());
+            CHECK(actual == expected);
+
+            auto const stats{ uploader.stats() };
+            CHECK(stats.ring_size >= 256);
+            CHECK(stats.bytes_uploaded == expected.size());
+            CHECK(stats.upload_count == chunk_count);
+            CHECK(stats.batch_count > 1);
+            CHECK(stats.stall_count > 0);
+            CHECK(stats.peak_ring_usage <= stats.ring_size);
+
+            CHECK_THROWS_AS(uploader.upload(*buffer, 0, std::vector<std::byte>(stats.ring_size + 1)),
+                            orbi::uploader::error);
+
+            device->allocator().free(allocation);
+        }
+
+        SUBCASE("image")
+        {
+            constexpr vk::Format format{ vk::Format::eR8G8B8A8Unorm };
+            constexpr vk::Extent3D extent{ 4, 4, 1 };
+            constexpr std::size_t texel_size{ 4 };
+            constexpr std::size_t size{ extent.width * extent.height * texel_size };
+
+            vk::raii::Image const image{ vk_device,
+                                         { .imageType = vk::ImageType::e2D,
+                                           .format = format,
+                                           .extent = extent,
+                                           .mipLevels = 1,
+                                           .arrayLayers = 1,
+                                           .samples = vk::SampleCountFlagBits::e1,
+                                           .tiling = vk::ImageTiling::eOptimal,
+                                           .usage = vk::ImageUsageFlagBits::eTransferDst |
+                                                    vk::ImageUsageFlagBits::eTransferSrc,
+                                           .initialLayout = vk::ImageLayout::eUndefined } };
+
+            auto const image_allocation{ device->allocator().allocate(
+                { .requirements = image.getMemoryRequirements(), .usage = orbi::memory_usage::gpu_only }) };
+            image.bindMemory(image_allocation.memory, image_allocation.offset);
+
+            vk::raii::Buffer const buffer{ vk_device,
+                                           { .size = size, .usage = vk::BufferUsageFlagBits::eTransferDst } };
+
+            auto const allocation{ device->allocator().allocate(
+                { .requirements = buffer.getMemoryRequirements(), .usage = orbi::memory_usage::readback }) };
+            buffer.bindMemory(allocation.memory, allocation.offset);
+
+            orbi::uploader uploader{ *device, 256 };
+
+            auto const expected{ make_bytes(size, 3) };
+
+            // two regions of the same subresource in one batch, both must survive
+            auto const half_height{ extent.height / 2 };
+            auto const half_size{ size / 2 };
+            for (std::uint32_t i{ 0 }; i < 2; ++i)
+            {
+                orbi::image_upload_region const region{
+                    .format = format,
+                    .offset = { 0, static_cast<std::int32_t>(i * half_height), 0 },
+                    .extent = { extent.width, half_height, 1 },
+                };
+                uploader.upload(*image, region, std::span{ expected.data() + i * half_size, half_size },
+                                vk::ImageLayout::eTransferSrcOptimal);
+            }
+
+            uploader.flush();
+            submit(*device, renderer, uploader,
+                   [&](vk::raii::CommandBuffer const& command_buffer)
+                   {
+                       command_buffer.copyImageToBuffer(
+                           *image, vk::ImageLayout::eTransferSrcOptimal, *buffer,
+                           vk::BufferImageCopy{ .imageSubresource = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                                                      .layerCount = 1 },
+                                                .imageExtent = extent });
+                   });
+
+            std::vector<std::byte> actual(expected.size());
+            std::memcpy(actual.data(), allocation.mapped, actual.size());
+            CHECK(actual == expected);
+
+            device->allocator().free(allocation);
+            device->allocator().free(image_allocation);
+        }
+    }
+}